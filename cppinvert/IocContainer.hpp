@@ -1,24 +1,209 @@
 #pragma once
 
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <deque>
+#include <exception>
+#include <functional>
 #include <iosfwd>
+#include <list>
 #include <memory>
 #include <mutex>
 #include <string>
+#include <string_view>
+#include <thread>
+#include <tuple>
 #include <type_traits>
 #include <unordered_map>
+#include <utility>
+#include <vector>
 
-#include <boost/any.hpp>
+#ifdef __linux__
+#include <fstream>
+#include <sched.h>
+#endif
+
+// With CPPINVERT_NO_BOOST, only the standard library is used. Exceptions then carry their
+// message in what(), rather than as Boost error info
+#ifndef CPPINVERT_NO_BOOST
+#include <boost/config.hpp>
 #include <boost/core/demangle.hpp>
 #include <boost/core/noncopyable.hpp>
-#include <boost/core/null_deleter.hpp>
 #include <boost/exception/all.hpp>
 #include <boost/format.hpp>
 #include <boost/throw_exception.hpp>
+#else
+#include <sstream>
+#include <typeinfo>
+#if __has_include(<cxxabi.h>)
+#include <cxxabi.h>
+#endif
+#endif
+
+// Without RTTI, types are only identified at compile time, and named by the signature
+// of a function template instead of typeid
+#if !defined(CPPINVERT_NO_RTTI) &&                                                                 \
+    (defined(BOOST_NO_RTTI) ||                                                                     \
+     (defined(CPPINVERT_NO_BOOST) && !defined(__cpp_rtti) && !defined(_CPPRTTI)))
+#define CPPINVERT_NO_RTTI
+#endif
+
+// Without exceptions, errors are reported through the try* methods, which return a Result
+// or an ErrorCode. Errors from the other methods terminate the program instead. Each method
+// that can fail has a try* variant, while those returning a reference, such as getRef, are
+// covered by tryGetPtr. As for any use of Boost without exceptions, boost::throw_exception
+// must be defined by the program
+#if !defined(CPPINVERT_NO_EXCEPTIONS) &&                                                           \
+    (defined(BOOST_NO_EXCEPTIONS) ||                                                               \
+     (defined(CPPINVERT_NO_BOOST) && !defined(__cpp_exceptions) && !defined(_CPPUNWIND)))
+#define CPPINVERT_NO_EXCEPTIONS
+#endif
 
 namespace cppinvert
 {
 
+namespace detail
+{
+
+#ifndef CPPINVERT_NO_BOOST
+using boost::noncopyable;
+using boost::format;
+using boost::str;
+using boost::core::demangle;
+#else
+class noncopyable
+{
+protected:
+    noncopyable() = default;
+    ~noncopyable() = default;
+
+    noncopyable(const noncopyable&) = delete;
+    noncopyable& operator=(const noncopyable&) = delete;
+};
+
+/// Minimal replacement for boost::format, which substitutes the arguments for the
+/// placeholders %1%, %2% and so on
+class format
+{
+public:
+    explicit format(const char* fmt)
+        : fmt_(fmt)
+        , args_()
+    {
+    }
+
+    template <class TArg>
+    format& operator%(const TArg& arg)
+    {
+        std::ostringstream stream;
+        stream << arg;
+        args_.push_back(stream.str());
+        return *this;
+    }
+
+    std::string str() const
+    {
+        std::string result;
+
+        for (std::size_t pos = 0; pos < fmt_.size(); ++pos)
+        {
+            const auto end = fmt_[pos] == '%' ? fmt_.find('%', pos + 1) : std::string::npos;
+
+            if (end != std::string::npos)
+            {
+                std::size_t index = 0;
+                bool numeric = end > pos + 1;
+
+                for (auto digit = pos + 1; digit < end && numeric; ++digit)
+                {
+                    numeric = fmt_[digit] >= '0' && fmt_[digit] <= '9';
+                    index = index * 10 + static_cast<std::size_t>(fmt_[digit] - '0');
+                }
+
+                if (numeric && index >= 1 && index <= args_.size())
+                {
+                    result += args_[index - 1];
+                    pos = end;
+                    continue;
+                }
+            }
+
+            result += fmt_[pos];
+        }
+
+        return result;
+    }
+
+private:
+    std::string fmt_;
+    std::vector<std::string> args_;
+};
+
+inline std::string str(const format& fmt)
+{
+    return fmt.str();
+}
+
+inline std::string demangle(const char* name)
+{
+#if __has_include(<cxxabi.h>)
+    int status = 0;
+    std::unique_ptr<char, void (*)(void*)> demangled(
+        abi::__cxa_demangle(name, nullptr, nullptr, &status), &std::free);
+
+    if (status == 0 && demangled)
+    {
+        return demangled.get();
+    }
+#endif
+    return name;
+}
+#endif
+
+/// Returns the CPU the calling thread is running on, where the platform can tell. Otherwise
+/// threads are spread by their id, which still keeps each thread on a consistent index
+inline std::size_t currentCpu() noexcept
+{
+#ifdef __linux__
+    const int cpu = sched_getcpu();
+
+    if (cpu >= 0)
+    {
+        return static_cast<std::size_t>(cpu);
+    }
+#endif
+    return std::hash<std::thread::id>()(std::this_thread::get_id());
+}
+
+} // detail
+
+/// The reasons why the IOC container can fail to complete an operation
+enum class ErrorCode
+{
+    /// The operation succeeded
+    None,
+    /// No instance is held under the type and name, and none could be created
+    NotFound,
+    /// The held instance is of a different type than requested
+    TypeMismatch,
+    /// No container in the chain has a factory for the type
+    NoFactory,
+    /// None of the factories for the type can be invoked with the given arguments
+    UnknownSignature,
+    /// The factory only creates shared instances, so it can't provide a unique_ptr
+    SharedOnlyFactory,
+    /// The factory isn't memoized
+    NotMemoized,
+    /// An argument was passed to a factory with an incompatible value category
+    InvalidArgument
+};
+
+#ifndef CPPINVERT_NO_BOOST
 typedef boost::error_info<struct tag_errmsg, std::string> StringInfo;
+typedef boost::error_info<struct tag_errcode, ErrorCode> ErrorCodeInfo;
 
 /// A custom exception, so it's easier to track exceptions that are due to errors from the
 /// IOC container
@@ -29,6 +214,156 @@ public:
     {
         return "Library threw an exception";
     }
+
+    /// Returns the reason for the exception
+    ErrorCode code [[nodiscard]] () const noexcept
+    {
+        const auto* code = boost::get_error_info<ErrorCodeInfo>(*this);
+        return code ? *code : ErrorCode::None;
+    }
+};
+#else
+/// A custom exception, so it's easier to track exceptions that are due to errors from the
+/// IOC container
+class IocException : public std::exception
+{
+public:
+    IocException(ErrorCode code, std::string message)
+        : code_(code)
+        , message_(std::move(message))
+    {
+    }
+
+    virtual const char* what() const noexcept override
+    {
+        return message_.c_str();
+    }
+
+    /// Returns the reason for the exception
+    ErrorCode code [[nodiscard]] () const noexcept
+    {
+        return code_;
+    }
+
+private:
+    ErrorCode code_;
+    std::string message_;
+};
+#endif
+
+#if defined(CPPINVERT_NO_EXCEPTIONS)
+#define CPPINVERT_RAISE(code, message) ::cppinvert::abortWithError(code, message)
+#elif defined(CPPINVERT_NO_BOOST)
+#define CPPINVERT_RAISE(code, message) throw ::cppinvert::IocException(code, message)
+#else
+#define CPPINVERT_RAISE(code, message)                                                             \
+    BOOST_THROW_EXCEPTION(::cppinvert::IocException()                                              \
+                          << ::cppinvert::StringInfo(message) << ::cppinvert::ErrorCodeInfo(code))
+#endif
+
+#ifdef CPPINVERT_NO_EXCEPTIONS
+/// Reports an error that can't be returned, when built without exceptions
+[[noreturn]] inline void abortWithError(ErrorCode code, const std::string& message) noexcept
+{
+    std::fprintf(stderr, "cppinvert error %d: %s\n", static_cast<int>(code), message.c_str());
+    std::abort();
+}
+#endif
+
+/// The result of an operation which can fail, holding either a value or an ErrorCode. The
+/// try* methods of the IOC container return results, so failures never need to unwind
+/// @tparam T The type of the value, which must be default constructible
+template <class T>
+class Result
+{
+public:
+    Result(T value) noexcept(std::is_nothrow_move_constructible_v<T>)
+        : value_(std::move(value))
+        , error_(ErrorCode::None)
+    {
+    }
+
+    Result(ErrorCode error) noexcept(std::is_nothrow_default_constructible_v<T>)
+        : value_()
+        , error_(error)
+    {
+    }
+
+    /// Checks whether the result holds a value
+    bool hasValue [[nodiscard]] () const noexcept
+    {
+        return error_ == ErrorCode::None;
+    }
+
+    explicit operator bool() const noexcept
+    {
+        return hasValue();
+    }
+
+    /// Returns the error, which is ErrorCode::None if the result holds a value
+    ErrorCode error [[nodiscard]] () const noexcept
+    {
+        return error_;
+    }
+
+    /// Returns the value
+    /// @throws IocException If the result holds an error
+    T& value [[nodiscard]] () &
+    {
+        check();
+        return value_;
+    }
+
+    const T& value [[nodiscard]] () const&
+    {
+        check();
+        return value_;
+    }
+
+    T&& value [[nodiscard]] () &&
+    {
+        check();
+        return std::move(value_);
+    }
+
+    /// Returns the value, or the given value if the result holds an error
+    T valueOr [[nodiscard]] (T otherwise) const
+    {
+        return hasValue() ? value_ : std::move(otherwise);
+    }
+
+    /// Accesses the value, which the result must hold
+    T& operator*() noexcept
+    {
+        return value_;
+    }
+
+    const T& operator*() const noexcept
+    {
+        return value_;
+    }
+
+    T* operator->() noexcept
+    {
+        return &value_;
+    }
+
+    const T* operator->() const noexcept
+    {
+        return &value_;
+    }
+
+private:
+    void check() const
+    {
+        if (!hasValue())
+        {
+            CPPINVERT_RAISE(error_, "Result holds an error instead of a value");
+        }
+    }
+
+    T value_;
+    ErrorCode error_;
 };
 
 template <class T>
@@ -44,11 +379,26 @@ struct is_reference_wrapper<std::reference_wrapper<T>> : std::true_type
 template <class T>
 inline constexpr bool is_reference_wrapper_v = is_reference_wrapper<T>::value;
 
+/// Whether Tag can be used as a tag, to distinguish bindings of the type T without a name.
+/// Tags are empty classes, which mustn't derive from T, so they can't be mistaken for the
+/// derived type of a binding
+template <class T, class Tag>
+inline constexpr bool is_tag_v =
+    std::is_class_v<Tag> && std::is_empty_v<Tag> && !std::is_base_of_v<T, Tag>;
+
+/// Declares the interfaces an instance can be resolved as, when it is bound, e.g.
+/// bindInstance(duck, implements<IFly, IQuack>())
+/// @tparam TBases The base classes of the instance
+template <class... TBases>
+struct implements
+{
+};
+
 /// Used to disambiguate a value that is meant to be handled as a value that will be
 /// copied or moved
 /// @tparam T The type in the value wrapper
 template <class T>
-class value_wrapper : private boost::noncopyable
+class value_wrapper : private detail::noncopyable
 {
 public:
     using type = T;
@@ -136,394 +486,4399 @@ struct NullDeleter
 
 /// Helper for a null deleter into a smarter pointer
 template <class T>
-static constexpr auto nullDeleter_v = NullDeleter<T>::value;
+inline constexpr auto nullDeleter_v = NullDeleter<T>::value;
 
-/// @brief Implementation of an IOC container for C++ code
-///
-/// A container that supports holding any type of object, as well as managing the
-/// specified lifetime. In addition, it can create objects if you register the
-/// appropriate factory with it. Note: The IOC container is also thread-safe
-class IocContainer : private boost::noncopyable
+/// A reference to an argument of a factory, which remembers the value category it was
+/// passed with. This allows arguments to be forwarded through a type-erased factory, so
+/// they are only copied if the factory itself takes them by value from an lvalue
+/// @tparam T The decayed type of the argument
+template <class T>
+class forwarded_arg
 {
 public:
-    /// Definition for a shared factory function for creating objects
-    template <class T, class... TArgs>
-    using SharedFactory = std::function<std::shared_ptr<T>(std::decay_t<TArgs>...)>;
-
-    /// Definition for a factory function for creating objects
-    template <class T, class... TArgs>
-    using Factory = std::function<std::unique_ptr<T>(std::decay_t<TArgs>...)>;
-
-    /// Creates the IOC container and also defaults to registering a factory of an
-    /// IOC container, so that sub-containers may be created upon request
-    IocContainer()
-        : parent_(nullptr)
-        , registeredFactories_()
-        , registeredInstances_()
-        , mutex_()
+    explicit forwarded_arg(T& value) noexcept
+        : ptr_(&value)
+        , category_(Category::LValue)
     {
-        // By default, bind a factory any time an IOC container is requested
-        Factory<IocContainer> factoryFunc = [this]() {
-            // Reference parent for factories
-            auto container{std::make_unique<IocContainer>()};
-            container->parent_ = this;
-
-            return container;
-        };
-
-        registerFactory<IocContainer>(factoryFunc);
     }
 
-    /// Move constructor
-    /// @param other The IOC container to take resources from
-    IocContainer(IocContainer&& other) noexcept
-        : parent_(std::move(other.parent_))
-        , registeredFactories_(std::move(other.registeredFactories_))
-        , registeredInstances_(std::move(other.registeredInstances_))
-        , mutex_()
+    explicit forwarded_arg(const T& value) noexcept
+        : ptr_(const_cast<T*>(&value))
+        , category_(Category::ConstLValue)
     {
     }
 
-    /// Destroys the IOC container
-    ~IocContainer()
+    explicit forwarded_arg(T&& value) noexcept
+        : ptr_(&value)
+        , category_(Category::RValue)
     {
     }
 
-    IocContainer& operator=(IocContainer&& other) noexcept
+    /// Produces the argument as the parameter type that the factory declared
+    /// @tparam TParam The type of the factory parameter
+    /// @returns The argument, forwarded as the parameter type
+    /// @throws IocException If the argument cannot be bound to the parameter type
+    template <class TParam>
+    TParam get [[nodiscard]] () const
     {
-        if (this == &other)
+        static_assert(std::is_same_v<std::decay_t<TParam>, T>, "Parameter type mismatch");
+
+        check(accepts<TParam>(), expected<TParam>());
+        if constexpr (std::is_lvalue_reference_v<TParam>)
         {
-            return *this;
+            return *ptr_;
         }
+        else if constexpr (std::is_rvalue_reference_v<TParam> ||
+                           !std::is_copy_constructible_v<T>)
+        {
+            return std::move(*ptr_);
+        }
+        else
+        {
+            if (category_ == Category::RValue)
+            {
+                return std::move(*ptr_);
+            }
 
-        parent_ = std::move(other.parent_);
-        registeredFactories_ = std::move(other.registeredFactories_);
-        registeredInstances_ = std::move(other.registeredInstances_);
-
-        return *this;
+            return *ptr_;
+        }
     }
 
-    /// Return the size of the container. In this context, the size means the number of
-    /// instances that are held in the container
-    /// @param[in] recursive Provides a mechanism for counting the number of instances in
-    /// all subcontainers, as well
-    /// @returns The calculated size
-    /// NOTE: This calculation has a caveat. While the parent IOC container is locked, if
-    /// you are doing
-    ///     the recursive case, those will only be locked when they individually count
-    ///     their size, and so on, so it's possible that the count will not be an exact
-    ///     snapshot for that moment in time
-    std::size_t size [[nodiscard]] (bool recursive = false) const
+    /// Checks whether the argument can be produced as the parameter type, without raising
+    /// the error that get would
+    /// @tparam TParam The type of the factory parameter
+    template <class TParam>
+    bool accepts [[nodiscard]] () const noexcept
     {
-        Lock lock(mutex_);
+        using Unqualified = std::remove_reference_t<TParam>;
 
-        std::size_t size = 0;
-
-        for (const auto& item : registeredInstances_)
+        if constexpr (std::is_rvalue_reference_v<TParam>)
         {
-            size += item.second.size();
+            return category_ == Category::RValue;
         }
-
-        if (recursive)
+        else if constexpr (std::is_lvalue_reference_v<TParam> && std::is_const_v<Unqualified>)
         {
-            auto typeName = getType(*this);
-
-            if (registeredInstances_.count(typeName))
-            {
-                auto& innerMap = registeredInstances_.at(typeName);
-
-                for (const auto& mapPair : innerMap)
-                {
-                    auto item = boost::any_cast<HolderPtr<IocContainer>>(mapPair.second);
-                    size += item->size(recursive);
-                }
-            }
+            return true;
+        }
+        else if constexpr (std::is_lvalue_reference_v<TParam>)
+        {
+            return category_ == Category::LValue;
+        }
+        else
+        {
+            return std::is_copy_constructible_v<T> || category_ == Category::RValue;
         }
-
-        return size;
     }
 
-    /// Registers a default factory function for a given type. It implicitly does new T()
-    /// to create the type
-    /// @tparam T The type of the instance that will be created
-    /// @returns Reference to the IocContainer, for chaining operations
-    template <class T>
-    IocContainer& registerDefaultFactory()
+private:
+    enum class Category
     {
-        return registerDefaultFactory<T, T>();
+        LValue,
+        ConstLValue,
+        RValue
+    };
+
+    // Describes the arguments that can be produced as the parameter type
+    template <class TParam>
+    static constexpr const char* expected() noexcept
+    {
+        if constexpr (std::is_rvalue_reference_v<TParam>)
+        {
+            return "an rvalue";
+        }
+        else if constexpr (std::is_lvalue_reference_v<TParam>)
+        {
+            return "a non-const lvalue";
+        }
+        else
+        {
+            return "an rvalue, as it cannot be copied";
+        }
     }
 
-    /// Registers a default factory function for a given type. It implicitly does new T()
-    /// to create the type
-    /// @tparam T The type of the instance that will be created
-    /// @tparam TConcrete The type of the concrete instance that will be created
-    /// @returns Reference to the IocContainer, for chaining operations
-    template <class T, class TConcrete, class... TArgs>
-    IocContainer& registerDefaultFactory()
+    static void check(bool valid, const char* expected)
     {
-        Factory<T, TArgs...> factory = [](TArgs... args) {
-            return std::make_unique<TConcrete>(args...);
-        };
+        if (!valid)
+        {
+            CPPINVERT_RAISE(ErrorCode::InvalidArgument,
+                            std::string("Factory parameter must be passed ") + expected);
+        }
+    }
+
+    T* ptr_;
+    Category category_;
+};
+
+/// Deduces the signature of a callable, such as a std::function or a lambda
+/// @tparam T The type of the callable
+template <class T>
+struct callable_traits : callable_traits<decltype(&T::operator())>
+{
+};
+
+template <class TResult, class... TArgs>
+struct callable_traits<TResult(TArgs...)>
+{
+    using result_type = TResult;
+
+    static constexpr std::size_t arity = sizeof...(TArgs);
+
+    template <template <class...> class TTarget, class... TPrefix>
+    using apply_args = TTarget<TPrefix..., TArgs...>;
+};
+
+template <class TResult, class... TArgs>
+struct callable_traits<TResult (*)(TArgs...)> : callable_traits<TResult(TArgs...)>
+{
+};
+
+template <class TClass, class TResult, class... TArgs>
+struct callable_traits<TResult (TClass::*)(TArgs...)> : callable_traits<TResult(TArgs...)>
+{
+};
+
+template <class TClass, class TResult, class... TArgs>
+struct callable_traits<TResult (TClass::*)(TArgs...) const> : callable_traits<TResult(TArgs...)>
+{
+};
+
+#if defined(__cpp_consteval)
+#define CPPINVERT_CONSTEVAL consteval
+#else
+#define CPPINVERT_CONSTEVAL constexpr
+#endif
+
+/// Key for the name of a named instance or factory. The name is hashed upon construction,
+/// so named lookups only compare the name itself when the hashes match. For the _ioc
+/// literal and IOC_NAME, the hash is computed at compile time. The key doesn't own the
+/// name, so it must not outlive the string it was created from
+class NameKey
+{
+public:
+    /// Creates the key of the empty name, which is the name of unnamed instances
+    constexpr NameKey() noexcept
+        : NameKey(std::string_view())
+    {
+    }
+
+    constexpr NameKey(const char* name) noexcept
+        : NameKey(std::string_view(name))
+    {
+    }
+
+    constexpr NameKey(std::string_view name) noexcept
+        : name_(name)
+        , hash_(hashOf(name))
+    {
+    }
+
+    NameKey(const std::string& name) noexcept
+        : NameKey(std::string_view(name))
+    {
+    }
+
+    /// Creates a key from a hash that was already computed with hashOf, see IOC_NAME
+    constexpr NameKey(std::string_view name, std::size_t hash) noexcept
+        : name_(name)
+        , hash_(hash)
+    {
+    }
+
+    /// Returns the name
+    constexpr std::string_view str [[nodiscard]] () const noexcept
+    {
+        return name_;
+    }
+
+    /// Returns the hash of the name
+    constexpr std::size_t hash [[nodiscard]] () const noexcept
+    {
+        return hash_;
+    }
+
+    /// Hashes a name with FNV-1a
+    static constexpr std::size_t hashOf [[nodiscard]] (std::string_view name) noexcept
+    {
+        std::uint64_t hash = 14695981039346656037ull;
+
+        for (char c : name)
+        {
+            hash = (hash ^ static_cast<unsigned char>(c)) * 1099511628211ull;
+        }
+
+        return static_cast<std::size_t>(hash);
+    }
+
+private:
+    std::string_view name_;
+    std::size_t hash_;
+};
+
+inline namespace literals
+{
+
+/// Creates the key of a name at compile time, e.g. iocContainer.getRef<int>("width"_ioc)
+CPPINVERT_CONSTEVAL NameKey operator""_ioc(const char* name, std::size_t size) noexcept
+{
+    return NameKey(std::string_view(name, size));
+}
+
+} // literals
+
+/// Creates the key of a name, whose hash is computed at compile time
+#define IOC_NAME(name)                                                                             \
+    ::cppinvert::NameKey(                                                                          \
+        name, std::integral_constant<std::size_t, ::cppinvert::NameKey::hashOf(name)>::value)
+
+/// A group of instances created together by IocContainer::createMany. When the concrete
+/// type is known, the instances are constructed in a single contiguous allocation, so
+/// creating them allocates a constant number of times and iterating them is cache-friendly
+/// @tparam T The type the instances are accessed as
+template <class T>
+class InstanceGroup : private detail::noncopyable
+{
+public:
+    /// Iterates the instances of the group in order
+    class iterator
+    {
+    public:
+        using iterator_category = std::forward_iterator_tag;
+        using value_type = T;
+        using difference_type = std::ptrdiff_t;
+        using pointer = T*;
+        using reference = T&;
+
+        iterator(const InstanceGroup* group, std::size_t index) noexcept
+            : group_(group)
+            , index_(index)
+        {
+        }
+
+        T& operator*() const noexcept
+        {
+            return (*group_)[index_];
+        }
+
+        T* operator->() const noexcept
+        {
+            return &(*group_)[index_];
+        }
+
+        iterator& operator++() noexcept
+        {
+            ++index_;
+            return *this;
+        }
+
+        iterator operator++(int) noexcept
+        {
+            return iterator(group_, index_++);
+        }
+
+        bool operator==(const iterator& rhs) const noexcept
+        {
+            return group_ == rhs.group_ && index_ == rhs.index_;
+        }
+
+        bool operator!=(const iterator& rhs) const noexcept
+        {
+            return !(*this == rhs);
+        }
+
+    private:
+        const InstanceGroup* group_;
+        std::size_t index_;
+    };
+
+    /// Constructs the instances in a single contiguous allocation
+    /// @tparam TConcrete The concrete type of the instances
+    /// @param[in] count The number of instances to construct
+    /// @param[in] args The arguments each of the instances is constructed with
+    /// @returns The created group
+    template <class TConcrete, class... TArgs>
+    static std::shared_ptr<InstanceGroup> make(std::size_t count, const TArgs&... args)
+    {
+        // Cleans up the constructed instances, should one of the constructors throw
+        struct Guard
+        {
+            ~Guard()
+            {
+                if (block != nullptr)
+                {
+                    destroyBlock<TConcrete>(block, constructed, count);
+                }
+            }
+
+            TConcrete* block;
+            std::size_t constructed;
+            std::size_t count;
+        };
+
+        Guard guard{std::allocator<TConcrete>().allocate(count), 0, count};
+
+        for (; guard.constructed < count; ++guard.constructed)
+        {
+            new (guard.block + guard.constructed) TConcrete(args...);
+        }
+
+        auto group = std::make_shared<InstanceGroup>(
+            guard.block, count, &accessBlock<TConcrete>, &destroyBlock<TConcrete>);
+        guard.block = nullptr;
+
+        return group;
+    }
+
+    /// Creates a group from instances that were created separately
+    /// @param[in] instances The instances of the group
+    /// @returns The created group
+    static std::shared_ptr<InstanceGroup> make(std::vector<std::shared_ptr<T>> instances)
+    {
+        auto block = std::make_unique<Instances>(std::move(instances));
+        auto group = std::make_shared<InstanceGroup>(
+            block.get(), block->size(), &accessInstances, &destroyInstances);
+        block.release();
+
+        return group;
+    }
+
+    using Accessor = T* (*)(void* block, std::size_t index);
+    using Destroyer = void (*)(void* block, std::size_t constructed, std::size_t count);
+
+    /// Takes ownership of a block of instances. Use make to create groups
+    InstanceGroup(void* block, std::size_t size, Accessor accessor, Destroyer destroyer) noexcept
+        : block_(block)
+        , size_(size)
+        , accessor_(accessor)
+        , destroyer_(destroyer)
+    {
+    }
+
+    ~InstanceGroup()
+    {
+        destroyer_(block_, size_, size_);
+    }
+
+    /// Returns the number of instances in the group
+    std::size_t size [[nodiscard]] () const noexcept
+    {
+        return size_;
+    }
+
+    /// Returns the instance at the given index, which must be less than the size
+    T& operator[](std::size_t index) const noexcept
+    {
+        return *accessor_(block_, index);
+    }
+
+    iterator begin [[nodiscard]] () const noexcept
+    {
+        return iterator(this, 0);
+    }
+
+    iterator end [[nodiscard]] () const noexcept
+    {
+        return iterator(this, size_);
+    }
+
+private:
+    using Instances = std::vector<std::shared_ptr<T>>;
+
+    template <class TConcrete>
+    static T* accessBlock(void* block, std::size_t index) noexcept
+    {
+        return static_cast<TConcrete*>(block) + index;
+    }
+
+    template <class TConcrete>
+    static void destroyBlock(void* block, std::size_t constructed, std::size_t count) noexcept
+    {
+        auto* instances = static_cast<TConcrete*>(block);
+
+        for (std::size_t index = constructed; index > 0; --index)
+        {
+            instances[index - 1].~TConcrete();
+        }
+
+        std::allocator<TConcrete>().deallocate(instances, count);
+    }
+
+    static T* accessInstances(void* block, std::size_t index) noexcept
+    {
+        return (*static_cast<Instances*>(block))[index].get();
+    }
+
+    static void destroyInstances(void* block, std::size_t, std::size_t) noexcept
+    {
+        delete static_cast<Instances*>(block);
+    }
+
+    void* block_;
+    std::size_t size_;
+    Accessor accessor_;
+    Destroyer destroyer_;
+};
+
+/// An instance which can be replaced while it is in use, see IocContainer::swap. Readers
+/// take a reference to the current instance without any lock of the container, and keep
+/// using it until they drop it, while new readers get the replacement
+/// @tparam T The type of the instance
+template <class T>
+class Swappable : private detail::noncopyable
+{
+public:
+    /// Creates the slot with its initial instance
+    /// @param[in] instance The initial instance
+    explicit Swappable(std::shared_ptr<T> instance) noexcept
+        : instance_(std::move(instance))
+    {
+    }
+
+    /// Returns the current instance
+    std::shared_ptr<T> load [[nodiscard]] () const noexcept
+    {
+#ifdef __cpp_lib_atomic_shared_ptr
+        return instance_.load(std::memory_order_acquire);
+#else
+        return std::atomic_load_explicit(&instance_, std::memory_order_acquire);
+#endif
+    }
+
+    /// Replaces the instance, which new readers will see from then on
+    /// @param[in] instance The new instance
+    /// @returns The replaced instance
+    std::shared_ptr<T> exchange(std::shared_ptr<T> instance) noexcept
+    {
+#ifdef __cpp_lib_atomic_shared_ptr
+        return instance_.exchange(std::move(instance), std::memory_order_acq_rel);
+#else
+        return std::atomic_exchange_explicit(
+            &instance_, std::move(instance), std::memory_order_acq_rel);
+#endif
+    }
+
+private:
+#ifdef __cpp_lib_atomic_shared_ptr
+    std::atomic<std::shared_ptr<T>> instance_;
+#else
+    // Only accessed through the atomic functions for shared_ptr
+    std::shared_ptr<T> instance_;
+#endif
+};
+
+namespace detail
+{
+
+/// Tracks the readers of a container by epoch, so that retired instances can be released
+/// once no reader can still refer to them. Readers are counted on one of several cache
+/// lines, chosen by their thread, so readers on different threads rarely contend
+class EpochDomain : private noncopyable
+{
+    // Counts the readers of a few threads, for each parity of the epoch
+    struct alignas(64) Stripe
+    {
+        std::atomic<std::uint32_t> readers[2] = {};
+    };
+
+    static constexpr std::size_t stripeCount = 64;
+
+public:
+    /// Marks a reader as active, for as long as it exists
+    class Guard
+    {
+    public:
+        explicit Guard(std::atomic<std::uint32_t>* readers) noexcept
+            : readers_(readers)
+        {
+        }
+
+        Guard(Guard&& rhs) noexcept
+            : readers_(std::exchange(rhs.readers_, nullptr))
+        {
+        }
+
+        Guard(const Guard&) = delete;
+        Guard& operator=(const Guard&) = delete;
+        Guard& operator=(Guard&&) = delete;
+
+        ~Guard()
+        {
+            if (readers_)
+            {
+                readers_->fetch_sub(1, std::memory_order_release);
+            }
+        }
+
+    private:
+        std::atomic<std::uint32_t>* readers_;
+    };
+
+    /// Marks the calling thread as a reader in the current epoch
+    Guard enter [[nodiscard]] () noexcept
+    {
+        auto& stripe = stripes_[threadStripe()];
+
+        for (;;)
+        {
+            const auto epoch = epoch_.load(std::memory_order_seq_cst);
+            auto& readers = stripe.readers[epoch & 1];
+            readers.fetch_add(1, std::memory_order_seq_cst);
+
+            // If the epoch moved on in the meantime, the reader may have been missed
+            if (epoch_.load(std::memory_order_seq_cst) == epoch)
+            {
+                return Guard(&readers);
+            }
+
+            readers.fetch_sub(1, std::memory_order_release);
+        }
+    }
+
+    /// Starts a new epoch, and waits for the readers of the previous epoch to finish. Any
+    /// instance that was retired before this call can be released afterwards. This mustn't
+    /// be called by a thread which is a reader itself
+    void synchronize()
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+
+        const auto epoch = epoch_.fetch_add(1, std::memory_order_seq_cst);
+
+        for (auto& stripe : stripes_)
+        {
+            while (stripe.readers[epoch & 1].load(std::memory_order_acquire) != 0)
+            {
+                std::this_thread::yield();
+            }
+        }
+    }
+
+private:
+    // Returns the stripe of the calling thread
+    static std::size_t threadStripe() noexcept
+    {
+        static thread_local const std::size_t stripe =
+            std::hash<std::thread::id>()(std::this_thread::get_id()) % stripeCount;
+
+        return stripe;
+    }
+
+    Stripe stripes_[stripeCount];
+
+    // The current epoch, whose parity selects the reader counts new readers use
+    std::atomic<std::uint64_t> epoch_{0};
+
+    // Serializes starting new epochs
+    std::mutex mutex_;
+};
+
+} // detail
+
+/// A reference to an instance of the container, which is valid for as long as the
+/// borrowed reference exists, without holding a reference count on the instance. See
+/// IocContainer::borrow and Lender
+/// @tparam T The type of the instance
+template <class T>
+class Borrowed
+{
+public:
+    /// Creates an empty borrowed reference, which doesn't refer to any instance
+    Borrowed() noexcept
+        : instance_(nullptr)
+        , guard_(nullptr)
+    {
+    }
+
+    /// Creates the borrowed reference
+    /// @param[in] instance The instance
+    /// @param[in] guard Keeps the instance from being released
+    Borrowed(T* instance, detail::EpochDomain::Guard guard) noexcept
+        : instance_(instance)
+        , guard_(std::move(guard))
+    {
+    }
+
+    /// Returns a pointer to the instance
+    T* get [[nodiscard]] () const noexcept
+    {
+        return instance_;
+    }
+
+    T& operator*() const noexcept
+    {
+        return *instance_;
+    }
+
+    T* operator->() const noexcept
+    {
+        return instance_;
+    }
+
+private:
+    T* instance_;
+    detail::EpochDomain::Guard guard_;
+};
+
+/// Lends an instance of the container out to many threads, see IocContainer::lend. The
+/// instance is resolved once, when the lender is created, and the lender holds the only
+/// reference count taken on it. Borrowing from the lender neither locks the container nor
+/// touches the reference count, but only marks the calling thread as a reader on a cache
+/// line shared with a few other threads
+/// @tparam T The type of the instance
+template <class T>
+class Lender : private detail::noncopyable
+{
+public:
+    /// Creates the lender
+    /// @param[in] instance The instance to lend out
+    explicit Lender(std::shared_ptr<T> instance) noexcept
+        : instance_(std::move(instance))
+        , epochs_()
+    {
+    }
+
+    /// Waits for the references borrowed from the lender, before releasing the instance. So
+    /// the last reference to the lender mustn't be dropped by a thread which still holds one
+    ~Lender()
+    {
+        epochs_.synchronize();
+    }
+
+    /// Borrows the instance, which remains valid until the borrowed reference is destroyed,
+    /// even if the lender is destroyed in the meantime
+    /// @returns The borrowed instance
+    Borrowed<T> borrow [[nodiscard]] () const noexcept
+    {
+        return Borrowed<T>(instance_.get(), epochs_.enter());
+    }
+
+private:
+    std::shared_ptr<T> instance_;
+
+    // The readers of the borrowed references, which are separate from those of the
+    // container, so they never hold up its reclamation
+    mutable detail::EpochDomain epochs_;
+};
+
+/// Replicas of an instance, each of which is used by a subset of the threads, such as
+/// those running on one CPU or NUMA node. Each replica is created the first time it is
+/// used. Callers can hold on to the replicas, and find the replica for the calling thread
+/// without locking the container. See IocContainer::getReplicas
+/// @tparam T The type of the instances
+template <class T>
+class Replicas : private detail::noncopyable
+{
+public:
+    /// Returns the index of the replica for the calling thread, modulo the count
+    using Locator = std::function<std::size_t()>;
+
+    /// Creates the instance of a replica, given its index and the storage of the replica.
+    /// The instance is either constructed within the storage, or allocated elsewhere if the
+    /// replicas have no storage, in which case it is null
+    using Factory = std::function<std::shared_ptr<T>(std::size_t, void*)>;
+
+    /// Creates the replicas, none of which are created until they are used
+    /// @param[in] count The number of replicas
+    /// @param[in] locator Returns the index of the replica for the calling thread
+    /// @param[in] factory Creates the instance of a replica
+    /// @param[in] inPlace Whether each replica has storage for its instance, on cache lines
+    /// of its own
+    Replicas(std::size_t count, Locator locator, Factory factory, bool inPlace)
+        : storage_(inPlace ? std::make_unique<Storage[]>(count) : nullptr)
+        , replicas_(std::make_unique<Replica[]>(count))
+        , count_(count)
+        , locator_(std::move(locator))
+        , factory_(std::move(factory))
+    {
+    }
+
+    /// Returns the replica for the calling thread, which is created on first use. Threads
+    /// may migrate, so the replica should be found again for each use, rather than kept
+    T& local [[nodiscard]] ()
+    {
+        const auto index = locator_() % count_;
+        auto& replica = replicas_[index];
+
+        if (T* instance = replica.published.load(std::memory_order_acquire))
+        {
+            return *instance;
+        }
+
+        std::call_once(replica.created, [&] {
+            replica.instance = factory_(index, storage_ ? &storage_[index] : nullptr);
+            replica.published.store(replica.instance.get(), std::memory_order_release);
+        });
+
+        return *replica.instance;
+    }
+
+    /// Calls a function with each replica which was created
+    /// @param[in] func The function, which is called with a reference to each replica
+    template <class TFunc>
+    void forEach(TFunc func) const
+    {
+        for (std::size_t index = 0; index < count_; ++index)
+        {
+            if (T* instance = replicas_[index].published.load(std::memory_order_acquire))
+            {
+                func(*instance);
+            }
+        }
+    }
+
+    /// Returns the number of replicas, including those which weren't created yet
+    std::size_t size [[nodiscard]] () const noexcept
+    {
+        return count_;
+    }
+
+private:
+    // Storage for the instance of a replica, on cache lines of its own
+    struct alignas(64) Storage
+    {
+        alignas(T) unsigned char bytes[sizeof(T)];
+    };
+
+    // Once created, a replica is only read, so it can share a cache line with the others
+    struct Replica
+    {
+        std::once_flag created;
+        std::atomic<T*> published{nullptr};
+        std::shared_ptr<T> instance;
+    };
+
+    // Declared first, so the instances constructed within it are destroyed beforehand
+    std::unique_ptr<Storage[]> storage_;
+
+    std::unique_ptr<Replica[]> replicas_;
+    std::size_t count_;
+    Locator locator_;
+    Factory factory_;
+};
+
+/// The instances of a type with a per-thread lifetime, each of which is only used by the
+/// thread that created it. Each instance is created the first time its thread uses it, and
+/// released when the thread exits, or along with the instances. Callers can hold on to the
+/// instances, and find the one of the calling thread without locking the container. See
+/// IocContainer::getThreadLocal
+/// @tparam T The type of the instances
+template <class T>
+class ThreadLocal : public std::enable_shared_from_this<ThreadLocal<T>>,
+                    private detail::noncopyable
+{
+public:
+    /// Creates the instance of a thread
+    using Factory = std::function<std::shared_ptr<T>()>;
+
+    /// Creates the instances, none of which are created until they are used
+    /// @param[in] factory Creates the instance of a thread
+    explicit ThreadLocal(Factory factory)
+        : factory_(std::move(factory))
+        , id_(nextId().fetch_add(1, std::memory_order_relaxed))
+        , instances_()
+        , mutex_()
+    {
+    }
+
+    /// Returns the instance of the calling thread, which is created on first use. The
+    /// instance the thread used last is cached in a thread-local slot, so finding it again
+    /// is a single comparison, and the other instances are found in a thread-local map
+    T& local [[nodiscard]] ()
+    {
+        auto& entries = threadEntries();
+
+        if (entries.last.id == id_)
+        {
+            return *entries.last.instance;
+        }
+
+        auto iter = entries.entries.find(id_);
+        T* instance = iter != entries.entries.end() ? iter->second.instance : create(entries);
+
+        entries.last = Last{id_, instance};
+        return *instance;
+    }
+
+private:
+    // The instance of a thread, and the ThreadLocal which owns it
+    struct Entry
+    {
+        T* instance{nullptr};
+        std::weak_ptr<ThreadLocal> owner;
+    };
+
+    // The instance a thread used last, and the id of the ThreadLocal which owns it. The
+    // ids are never reused, so the instance is valid for as long as its owner is in use
+    struct Last
+    {
+        std::uint64_t id{0};
+        T* instance{nullptr};
+    };
+
+    // The instances of a thread, which are released by their owners when it exits
+    struct ThreadEntries
+    {
+        ~ThreadEntries()
+        {
+            for (auto& item : entries)
+            {
+                if (auto owner = item.second.owner.lock())
+                {
+                    owner->release();
+                }
+            }
+        }
+
+        // Drops the entries of instances that were destroyed, once the map has doubled in
+        // size since the last sweep, so that it only grows with the live instances
+        void purge()
+        {
+            if (entries.size() < sweepSize)
+            {
+                return;
+            }
+
+            for (auto iter = entries.begin(); iter != entries.end();)
+            {
+                iter = iter->second.owner.expired() ? entries.erase(iter) : std::next(iter);
+            }
+
+            sweepSize = std::max<std::size_t>(entries.size() * 2, 16);
+        }
+
+        Last last;
+        std::unordered_map<std::uint64_t, Entry> entries;
+        std::size_t sweepSize = 16;
+    };
+
+    // Identifies the ThreadLocal within the thread-local maps. Unlike the address, it is
+    // never reused, so a stale entry can't be mistaken for a new one. Zero is never used
+    static std::atomic<std::uint64_t>& nextId()
+    {
+        static std::atomic<std::uint64_t> id{1};
+
+        return id;
+    }
+
+    static ThreadEntries& threadEntries()
+    {
+        static thread_local ThreadEntries entries;
+
+        return entries;
+    }
+
+    // Creates the instance of the calling thread
+    T* create(ThreadEntries& entries)
+    {
+        auto instance = factory_();
+        T* const created = instance.get();
+
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            instances_[std::this_thread::get_id()] = std::move(instance);
+        }
+
+        entries.purge();
+        entries.entries.emplace(id_, Entry{created, this->weak_from_this()});
+        return created;
+    }
+
+    // Releases the instance of the calling thread
+    void release()
+    {
+        std::shared_ptr<T> instance;
+
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+
+            auto iter = instances_.find(std::this_thread::get_id());
+
+            if (iter != instances_.end())
+            {
+                instance = std::move(iter->second);
+                instances_.erase(iter);
+            }
+        }
+    }
+
+    Factory factory_;
+    std::uint64_t id_;
+
+    // The instances of each thread
+    std::unordered_map<std::thread::id, std::shared_ptr<T>> instances_;
+
+    // Guards the instances, which are only added and removed as threads come and go
+    std::mutex mutex_;
+};
+
+/// The NUMA nodes of the machine, across which instances with a per-node lifetime are
+/// replicated. The topology of the machine is returned by system, while other
+/// implementations can simulate a topology, such as for testing
+class NumaTopology
+{
+public:
+    virtual ~NumaTopology()
+    {
+    }
+
+    /// Returns the number of nodes
+    virtual std::size_t nodeCount [[nodiscard]] () const = 0;
+
+    /// Returns the index of the node the calling thread is running on
+    virtual std::size_t currentNode [[nodiscard]] () const = 0;
+
+    /// Restricts the calling thread to the CPUs of a node, so the memory it allocates is
+    /// local to that node
+    /// @param[in] node The index of the node
+    virtual void pinToNode(std::size_t node) const = 0;
+
+    /// Returns the topology of the machine. Where the platform doesn't report one, the
+    /// machine is treated as a single node
+    static std::shared_ptr<const NumaTopology> system();
+};
+
+namespace detail
+{
+
+/// The topology of the machine, as reported by Linux in sysfs
+class SystemNumaTopology : public NumaTopology
+{
+public:
+    SystemNumaTopology()
+        : nodeCpus_()
+        , cpuNodes_()
+    {
+#ifdef __linux__
+        const std::string root = "/sys/devices/system/node/";
+
+        for (int node : parseList(readLine(root + "online")))
+        {
+            nodeCpus_.push_back(parseList(readLine(root + "node" + std::to_string(node) +
+                                                   "/cpulist")));
+
+            for (int cpu : nodeCpus_.back())
+            {
+                if (static_cast<std::size_t>(cpu) >= cpuNodes_.size())
+                {
+                    cpuNodes_.resize(cpu + 1);
+                }
+
+                cpuNodes_[cpu] = nodeCpus_.size() - 1;
+            }
+        }
+#endif
+
+        if (nodeCpus_.empty())
+        {
+            nodeCpus_.emplace_back();
+        }
+    }
+
+    std::size_t nodeCount() const override
+    {
+        return nodeCpus_.size();
+    }
+
+    std::size_t currentNode() const override
+    {
+        const auto cpu = currentCpu();
+
+        return cpu < cpuNodes_.size() ? cpuNodes_[cpu] : 0;
+    }
+
+    void pinToNode(std::size_t node) const override
+    {
+#ifdef __linux__
+        if (node >= nodeCpus_.size() || nodeCpus_[node].empty())
+        {
+            return;
+        }
+
+        cpu_set_t cpus;
+        CPU_ZERO(&cpus);
+
+        for (int cpu : nodeCpus_[node])
+        {
+            CPU_SET(cpu, &cpus);
+        }
+
+        sched_setaffinity(0, sizeof(cpus), &cpus);
+#else
+        static_cast<void>(node);
+#endif
+    }
+
+private:
+#ifdef __linux__
+    // Reads the first line of a file, which is empty if it can't be read
+    static std::string readLine(const std::string& path)
+    {
+        std::ifstream file(path);
+        std::string line;
+        std::getline(file, line);
+
+        return line;
+    }
+
+    // Parses a list of ranges, such as "0-3,8,10-11"
+    static std::vector<int> parseList(const std::string& list)
+    {
+        std::vector<int> values;
+        std::size_t pos = 0;
+
+        while (pos < list.size())
+        {
+            const auto end = std::min(list.find(',', pos), list.size());
+            const auto range = list.substr(pos, end - pos);
+            const auto dash = range.find('-');
+
+            const int first = std::atoi(range.c_str());
+            const int last = dash == std::string::npos ? first : std::atoi(&range[dash + 1]);
+
+            for (int value = first; value <= last; ++value)
+            {
+                values.push_back(value);
+            }
+
+            pos = end + 1;
+        }
+
+        return values;
+    }
+#endif
+
+    // The CPUs of each node
+    std::vector<std::vector<int>> nodeCpus_;
+
+    // The node of each CPU
+    std::vector<std::size_t> cpuNodes_;
+};
+
+} // detail
+
+inline std::shared_ptr<const NumaTopology> NumaTopology::system()
+{
+    static const auto topology = std::make_shared<const detail::SystemNumaTopology>();
+
+    return topology;
+}
+
+/// Lightweight identity of a type. Keys are compared and hashed by the address of a
+/// per-type static, so lookups never need to build or compare type names
+class TypeKey
+{
+public:
+    /// Creates an empty key, which doesn't refer to any type
+    constexpr TypeKey() noexcept
+        : info_(nullptr)
+    {
+    }
+
+    /// Returns the key for the given type
+    /// @tparam T The type to identify
+    /// @returns The key of the type
+    template <class T>
+    static constexpr TypeKey of [[nodiscard]] () noexcept
+    {
+        return TypeKey(&info<std::decay_t<T>>);
+    }
+
+    /// Returns the human-readable name of the type. This is only intended for diagnostics,
+    /// as it is comparatively expensive to build
+    std::string name [[nodiscard]] () const
+    {
+        return info_ ? info_->name() : std::string("<none>");
+    }
+
+    /// Returns a small integer, which is unique to the type within the process. Indices are
+    /// assigned densely, in the order types are first asked for theirs, so they can index
+    /// directly into arrays. After the first request, reading the index is a single load.
+    /// The key must not be empty
+    std::size_t index [[nodiscard]] () const
+    {
+        auto index = info_->index.load(std::memory_order_relaxed);
+
+        if (index == 0)
+        {
+            // Every thread assigns the same value, so a relaxed store is sufficient
+            index = info_->assignIndex() + 1;
+            info_->index.store(index, std::memory_order_relaxed);
+        }
+
+        return index - 1;
+    }
+
+    bool operator==(const TypeKey& rhs) const noexcept
+    {
+        return info_ == rhs.info_;
+    }
+
+    bool operator!=(const TypeKey& rhs) const noexcept
+    {
+        return info_ != rhs.info_;
+    }
+
+    /// Hash functor, so the key can be used within unordered containers
+    struct Hash
+    {
+        std::size_t operator()(const TypeKey& key) const noexcept
+        {
+            return std::hash<const void*>()(key.info_);
+        }
+    };
+
+private:
+    struct Info
+    {
+        std::string (*name)();
+        std::size_t (*assignIndex)();
+
+        // The dense index plus one, cached after the first request, or zero before it
+        mutable std::atomic<std::size_t> index;
+    };
+
+#ifndef CPPINVERT_NO_RTTI
+    template <class T>
+    static std::string demangledName()
+    {
+        return detail::demangle(typeid(T).name());
+    }
+#else
+    // Extracts the name of the type from the signature of this function
+    template <class T>
+    static std::string demangledName()
+    {
+#if defined(__clang__) || defined(__GNUC__)
+        // e.g. "... demangledName() [with T = Foo; ...]" or "... demangledName() [T = Foo]"
+        const std::string_view signature = __PRETTY_FUNCTION__;
+        const std::string_view prefix = "T = ";
+        const auto start = signature.find(prefix);
+
+        if (start != std::string_view::npos)
+        {
+            const auto first = start + prefix.size();
+            const auto last = signature.find_first_of(";]", first);
+            return std::string(signature.substr(first, last - first));
+        }
+#elif defined(_MSC_VER)
+        // e.g. "... __cdecl cppinvert::TypeKey::demangledName<class Foo>(void)"
+        const std::string_view signature = __FUNCSIG__;
+        const std::string_view prefix = "demangledName<";
+        const auto start = signature.find(prefix);
+        const auto last = signature.rfind(">(void)");
+
+        if (start != std::string_view::npos && last != std::string_view::npos)
+        {
+            const auto first = start + prefix.size();
+            return std::string(signature.substr(first, last - first));
+        }
+#endif
+        return "<unknown type>";
+    }
+#endif
+
+    // The index of each type is assigned once, the first time it is requested
+    template <class T>
+    static std::size_t denseIndex()
+    {
+        static const std::size_t index = nextIndex();
+
+        return index;
+    }
+
+    static std::size_t nextIndex()
+    {
+        static std::atomic<std::size_t> next{0};
+
+        return next.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    // Not constexpr, as the index is cached within it. Its address is still a constant
+    template <class T>
+    static inline Info info{&demangledName<T>, &denseIndex<T>, {0}};
+
+    constexpr explicit TypeKey(const Info* info) noexcept
+        : info_(info)
+    {
+    }
+
+    const Info* info_;
+};
+
+/// Type-erased storage for a single bound instance. Instances are normally held through a
+/// shared_ptr, but small trivially copyable values are stored inline, so holding them
+/// needs no heap allocation or reference count
+class InstanceHolder
+{
+    using SharedStorage = std::shared_ptr<void>;
+    using InlineStorage = std::aligned_storage_t<sizeof(SharedStorage), alignof(SharedStorage)>;
+
+public:
+    /// Converts a pointer to the instance of a linked holder to the instance of the link
+    using Adjust = void* (*)(void*);
+
+    /// Whether values of the given type are stored inline, rather than through a shared_ptr
+    template <class T>
+    static constexpr bool isInline = std::is_trivially_copyable_v<T> &&
+                                     sizeof(T) <= sizeof(InlineStorage) &&
+                                     alignof(T) <= alignof(InlineStorage);
+
+    /// Creates an empty holder
+    InstanceHolder() noexcept
+        : type_()
+        , isInline_(false)
+        , resolves_(false)
+        , adjust_(nullptr)
+    {
+        new (&storage_.shared) SharedStorage();
+    }
+
+    /// Creates a holder which shares ownership of the instance
+    /// @tparam T The type of the instance
+    /// @param[in] instance The instance to be held
+    template <class T>
+    explicit InstanceHolder(std::shared_ptr<T> instance) noexcept
+        : type_(TypeKey::of<T>())
+        , isInline_(false)
+        , resolves_(false)
+        , adjust_(nullptr)
+    {
+        // Cast away constness, so it can be stored type-erased. The type key retains the
+        // actual type, which is what is cast back to on retrieval
+        using Mutable = std::remove_cv_t<T>;
+        new (&storage_.shared)
+            SharedStorage(std::const_pointer_cast<Mutable>(std::move(instance)));
+    }
+
+    /// Creates a holder which stores the value inline
+    /// @tparam T The type of the value, which must be inline storable
+    /// @param[in] value The value to be held
+    template <class T>
+    static InstanceHolder makeInline [[nodiscard]] (const T& value) noexcept
+    {
+        static_assert(isInline<T>, "Type cannot be stored inline");
+
+        InstanceHolder holder;
+        holder.destroy();
+        new (&holder.storage_.value) std::remove_cv_t<T>(value);
+        holder.type_ = TypeKey::of<T>();
+        holder.isInline_ = true;
+        return holder;
+    }
+
+    /// Creates a holder which links to another holder, so that several keys can share a
+    /// single slot. The instance of the target is retrieved as the type of the link
+    /// @tparam T The type the instance is retrieved as through the link
+    /// @tparam TTarget The type of the instance held by the target, which must derive from T
+    /// @param[in] target The holder to link to
+    template <class T, class TTarget>
+    static InstanceHolder makeLink [[nodiscard]] (std::shared_ptr<InstanceHolder> target) noexcept
+    {
+        static_assert(std::is_base_of_v<T, TTarget> || std::is_same_v<T, TTarget>,
+                      "The linked instance must be convertible to the type of the link");
+
+        InstanceHolder holder;
+        holder.storage_.shared = std::move(target);
+        holder.type_ = TypeKey::of<T>();
+        holder.adjust_ = &adjust<std::remove_cv_t<T>, std::remove_cv_t<TTarget>>;
+        return holder;
+    }
+
+    /// Creates a holder which links to another holder, retrieving its instance through the
+    /// given function. The function may return a different instance each time, such as
+    /// one per thread
+    /// @tparam T The type the instance is retrieved as through the link
+    /// @param[in] target The holder to link to
+    /// @param[in] resolve Returns the instance of the link, given the instance of the target
+    template <class T>
+    static InstanceHolder makeLink [[nodiscard]] (std::shared_ptr<InstanceHolder> target,
+                                                  Adjust resolve) noexcept
+    {
+        InstanceHolder holder;
+        holder.storage_.shared = std::move(target);
+        holder.type_ = TypeKey::of<T>();
+        holder.resolves_ = true;
+        holder.adjust_ = resolve;
+        return holder;
+    }
+
+    InstanceHolder(const InstanceHolder& rhs) noexcept
+        : type_(rhs.type_)
+        , isInline_(rhs.isInline_)
+        , resolves_(rhs.resolves_)
+        , adjust_(rhs.adjust_)
+    {
+        constructFrom(rhs);
+    }
+
+    InstanceHolder(InstanceHolder&& rhs) noexcept
+        : type_(rhs.type_)
+        , isInline_(rhs.isInline_)
+        , resolves_(rhs.resolves_)
+        , adjust_(rhs.adjust_)
+    {
+        constructFrom(std::move(rhs));
+    }
+
+    ~InstanceHolder()
+    {
+        destroy();
+    }
+
+    InstanceHolder& operator=(const InstanceHolder& rhs) noexcept
+    {
+        if (this != &rhs)
+        {
+            destroy();
+            type_ = rhs.type_;
+            isInline_ = rhs.isInline_;
+            resolves_ = rhs.resolves_;
+            adjust_ = rhs.adjust_;
+            constructFrom(rhs);
+        }
+
+        return *this;
+    }
+
+    InstanceHolder& operator=(InstanceHolder&& rhs) noexcept
+    {
+        if (this != &rhs)
+        {
+            destroy();
+            type_ = rhs.type_;
+            isInline_ = rhs.isInline_;
+            resolves_ = rhs.resolves_;
+            adjust_ = rhs.adjust_;
+            constructFrom(std::move(rhs));
+        }
+
+        return *this;
+    }
+
+    /// Constructs a new instance within the holder, replacing any held instance. The
+    /// instance is allocated together with its reference count, or stored inline if it is
+    /// small enough. If construction throws, the held instance is left untouched
+    /// @tparam T The type of the instance
+    /// @param[in] args The arguments to construct the instance with
+    /// @returns The holder of the replaced instance, which is released along with it
+    template <class T, class... TArgs>
+    InstanceHolder emplace(TArgs&&... args)
+    {
+        if constexpr (isInline<T>)
+        {
+            const std::remove_cv_t<T> value(std::forward<TArgs>(args)...);
+            return assign(makeInline<T>(value));
+        }
+        else
+        {
+            return assign(InstanceHolder(std::make_shared<T>(std::forward<TArgs>(args)...)));
+        }
+    }
+
+    /// Replaces the held instance. If this is a link, and the new instance has the same type
+    /// as the linked instance, the instance is replaced for every key sharing the slot.
+    /// Otherwise only this holder is replaced, which detaches it from the shared slot
+    /// @param[in] holder The holder of the new instance
+    /// @returns The holder of the replaced instance, which is released along with it
+    InstanceHolder assign(InstanceHolder holder) noexcept
+    {
+        auto& replaced =
+            adjust_ && !holder.adjust_ && holder.type_ == target().type_ ? target() : *this;
+
+        std::swap(replaced, holder);
+        return holder;
+    }
+
+    /// Returns the type of the held instance
+    TypeKey type [[nodiscard]] () const noexcept
+    {
+        return type_;
+    }
+
+    /// Checks whether the holder holds an instance at all
+    bool empty [[nodiscard]] () const noexcept
+    {
+        return type_ == TypeKey();
+    }
+
+    /// Returns the shared_ptr which owns the held instance, following links. This is empty
+    /// for values stored inline, which are trivially destructible
+    std::shared_ptr<void> owner [[nodiscard]] () const noexcept
+    {
+        const auto& holder = adjust_ ? target() : *this;
+        return holder.isInline_ ? SharedStorage() : holder.storage_.shared;
+    }
+
+    /// Checks whether the holder links to a slot, which may be shared with other holders
+    bool linked [[nodiscard]] () const noexcept
+    {
+        return adjust_ != nullptr;
+    }
+
+    /// Checks whether the holder is a link which resolves its instance through a function,
+    /// which may create the instance, rather than just converting the instance of the slot
+    bool resolves [[nodiscard]] () const noexcept
+    {
+        return resolves_;
+    }
+
+    /// Returns the holder this holder links to, or nullptr if it isn't a link
+    const InstanceHolder* linkTarget [[nodiscard]] () const noexcept
+    {
+        return adjust_ ? &target() : nullptr;
+    }
+
+    /// Returns a pointer to the held instance. The caller must have checked the type
+    /// @tparam T The type of the instance
+    template <class T>
+    T* get [[nodiscard]] () const
+    {
+        if constexpr (isInline<T>)
+        {
+            if (isInline_)
+            {
+                auto* value = const_cast<InlineStorage*>(&storage_.value);
+                return std::launder(reinterpret_cast<T*>(value));
+            }
+        }
+
+        if (adjust_)
+        {
+            return static_cast<T*>(adjust_(target().address()));
+        }
+
+        return static_cast<T*>(storage_.shared.get());
+    }
+
+    /// Returns a shared_ptr to the held instance, following links. The caller must have
+    /// checked the type. Values stored inline have no reference count to share, so they are
+    /// returned as an owning copy, which remains valid after the value is replaced or erased
+    /// @tparam T The type of the instance
+    template <class T>
+    std::shared_ptr<T> getShared [[nodiscard]] () const
+    {
+        const auto& holder = adjust_ ? target() : *this;
+
+        if constexpr (isInline<T>)
+        {
+            if (holder.isInline_)
+            {
+                return std::make_shared<std::remove_cv_t<T>>(*get<T>());
+            }
+        }
+
+        return std::shared_ptr<T>(holder.storage_.shared, get<T>());
+    }
+
+private:
+    // Converts a pointer to the instance of a linked holder to the type of the link
+    template <class T, class TTarget>
+    static void* adjust(void* target) noexcept
+    {
+        return static_cast<T*>(static_cast<TTarget*>(target));
+    }
+
+    // Returns the holder a link refers to
+    InstanceHolder& target() const noexcept
+    {
+        return *static_cast<InstanceHolder*>(storage_.shared.get());
+    }
+
+    // Returns the address of the held instance, whichever way it is stored
+    void* address() const noexcept
+    {
+        return isInline_ ? const_cast<InlineStorage*>(&storage_.value) : storage_.shared.get();
+    }
+
+    // Destroys whichever member of the storage is active
+    void destroy() noexcept
+    {
+        if (!isInline_)
+        {
+            storage_.shared.~SharedStorage();
+        }
+    }
+
+    // Constructs the storage from another holder, whose state has already been copied
+    template <class THolder>
+    void constructFrom(THolder&& rhs) noexcept
+    {
+        if (isInline_)
+        {
+            storage_.value = rhs.storage_.value;
+        }
+        else
+        {
+            new (&storage_.shared) SharedStorage(std::forward<THolder>(rhs).storage_.shared);
+        }
+    }
+
+    // Members are constructed and destroyed explicitly by the holder
+    union Storage
+    {
+        Storage() noexcept
+        {
+        }
+
+        ~Storage()
+        {
+        }
+
+        SharedStorage shared;
+        InlineStorage value;
+    };
+
+    // Storage for the instance, which is either a shared_ptr or an inline value
+    Storage storage_;
+
+    // The type of the held instance
+    TypeKey type_;
+
+    // Whether the instance is stored inline
+    bool isInline_;
+
+    // Whether the holder is a link which resolves its instance, rather than converting it
+    bool resolves_;
+
+    // Set if the holder links to a slot shared with other keys, which is held in the storage
+    Adjust adjust_;
+};
+
+/// @brief Implementation of an IOC container for C++ code
+///
+/// A container that supports holding any type of object, as well as managing the
+/// specified lifetime. In addition, it can create objects if you register the
+/// appropriate factory with it. Note: The IOC container is also thread-safe
+class IocContainer : private detail::noncopyable
+{
+public:
+    /// Definition for a shared factory function for creating objects. Parameters may be
+    /// declared as references, e.g. const std::string& or std::vector<char>&&, in which case
+    /// the arguments passed to create are forwarded to the factory without being copied
+    template <class T, class... TArgs>
+    using SharedFactory = std::function<std::shared_ptr<T>(TArgs...)>;
+
+    /// Definition for a factory function for creating objects. Parameters may be declared
+    /// as references, e.g. const std::string& or std::vector<char>&&, in which case the
+    /// arguments passed to create are forwarded to the factory without being copied
+    template <class T, class... TArgs>
+    using Factory = std::function<std::unique_ptr<T>(TArgs...)>;
+
+    /// Which cached instance a memoized factory discards once it is at capacity
+    enum class EvictionPolicy
+    {
+        LeastRecentlyUsed,
+        FirstInFirstOut
+    };
+
+    /// When instances that are erased or replaced are released
+    enum class Reclamation
+    {
+        /// Instances are released straight away, by the call that erases or replaces them
+        Immediate,
+
+        /// Instances are retired, and only released by a later call to reclaim, outside of
+        /// the lock of the container. This keeps expensive destructors off the callers that
+        /// erase or replace instances, who may be on a hot path
+        Deferred
+    };
+
+    /// Which instance of a type registered with a factory is resolved by getRef and the other
+    /// get methods
+    enum class Lifetime
+    {
+        /// A single instance, which is created by the first get and then held
+        Singleton,
+
+        /// An instance per thread, which is created by the first get on each thread, and
+        /// released when the thread exits or the binding is erased. The get methods lock the
+        /// container to find the binding, while the instances found through getThreadLocal
+        /// are resolved without any lock
+        PerThread,
+
+        /// An instance per CPU, each on its own cache line, which is created by the first
+        /// get on that CPU. Threads may migrate between CPUs, so the instance must be safe
+        /// to use concurrently, but is rarely contended. See getReplicas and forEachReplica
+        PerCore,
+
+        /// An instance per NUMA node, which the factory creates on a thread pinned to that
+        /// node, so its memory is local to the threads using it. This suits large read-only
+        /// instances. See setNumaTopology, getReplicas and forEachReplica
+        PerNumaNode
+    };
+
+    /// How the instances of the container are released when it is destroyed
+    enum class ShutdownPolicy
+    {
+        /// Instances are released in no particular order
+        Unordered,
+
+        /// Instances are released in the reverse of the order they were bound or created in,
+        /// so an instance is released before those which were bound before it, such as the
+        /// dependencies its factory resolved. Only instances bound after setting the policy
+        /// are ordered, and any others are released first
+        DependencyOrdered,
+
+        /// Instances, factories and sub-containers are never released. This is intended for
+        /// processes which are about to exit, where the teardown would only slow them down
+        LeakOnExit
+    };
+
+    /// Statistics of the cache of a memoized factory
+    struct MemoizationStats
+    {
+        std::size_t hits{0};
+        std::size_t misses{0};
+        std::size_t evictions{0};
+        std::size_t size{0};
+    };
+
+    /// Creates the IOC container and also defaults to registering a factory of an
+    /// IOC container, so that sub-containers may be created upon request
+    IocContainer()
+        : parent_(nullptr)
+        , registeredFactories_()
+        , factoryMisses_()
+        , factoryGeneration_(0)
+        , registeredInstances_()
+        , unnamedInstances_()
+        , indexedInstances_()
+        , reclamation_(Reclamation::Immediate)
+        , retiredInstances_()
+        , shutdownPolicy_(ShutdownPolicy::Unordered)
+        , creationOrder_()
+        , epochs_()
+        , borrowing_(nullptr)
+        , numaTopology_()
+        , mutex_()
+    {
+        // By default, bind a factory any time an IOC container is requested
+        Factory<IocContainer> factoryFunc = [this]() {
+            // Reference parent for factories, and shut down the same way
+            auto container{std::make_unique<IocContainer>()};
+            container->parent_ = this;
+            container->shutdownPolicy_ = shutdownPolicy();
+
+            return container;
+        };
+
+        // Nothing can have missed this factory yet, so the generation is left unchanged
+        using Invoker = FactoryInvoker<IocContainer>;
+        addInvoker<IocContainer>("",
+                                 std::make_shared<typename Invoker::Signature>(
+                                     Invoker::template make<std::unique_ptr<IocContainer>>(
+                                         std::move(factoryFunc))));
+    }
+
+    /// Move constructor
+    /// @param other The IOC container to take resources from
+    IocContainer(IocContainer&& other) noexcept
+        : parent_(std::move(other.parent_))
+        , registeredFactories_(std::move(other.registeredFactories_))
+        , factoryMisses_()
+        , factoryGeneration_(0)
+        , registeredInstances_(std::move(other.registeredInstances_))
+        , unnamedInstances_(std::move(other.unnamedInstances_))
+        , indexedInstances_(std::move(other.indexedInstances_))
+        , reclamation_(other.reclamation_)
+        , retiredInstances_(std::move(other.retiredInstances_))
+        , shutdownPolicy_(other.shutdownPolicy_)
+        , creationOrder_(std::move(other.creationOrder_))
+        , epochs_(std::move(other.epochs_))
+        , borrowing_(other.borrowing_.exchange(nullptr))
+        , numaTopology_(std::move(other.numaTopology_))
+        , mutex_()
+    {
+    }
+
+    /// Destroys the IOC container, releasing its instances according to the shutdown policy
+    ~IocContainer()
+    {
+        switch (shutdownPolicy_)
+        {
+        case ShutdownPolicy::Unordered:
+            break;
+
+        case ShutdownPolicy::DependencyOrdered:
+            releaseInCreationOrder();
+            break;
+
+        case ShutdownPolicy::LeakOnExit:
+            leak();
+            break;
+        }
+    }
+
+    IocContainer& operator=(IocContainer&& other) noexcept
+    {
+        if (this == &other)
+        {
+            return *this;
+        }
+
+        parent_ = std::move(other.parent_);
+        registeredFactories_ = std::move(other.registeredFactories_);
+        factoryMisses_.clear();
+        factoryGeneration_.fetch_add(1, std::memory_order_release);
+        registeredInstances_ = std::move(other.registeredInstances_);
+        unnamedInstances_ = std::move(other.unnamedInstances_);
+        indexedInstances_ = std::move(other.indexedInstances_);
+        reclamation_ = other.reclamation_;
+        retiredInstances_ = std::move(other.retiredInstances_);
+        shutdownPolicy_ = other.shutdownPolicy_;
+        creationOrder_ = std::move(other.creationOrder_);
+        epochs_ = std::move(other.epochs_);
+        borrowing_ = other.borrowing_.exchange(nullptr);
+        numaTopology_ = std::move(other.numaTopology_);
+
+        return *this;
+    }
+
+    /// Sets when instances that are erased or replaced are released. Instances that were
+    /// already retired are kept until the next call to reclaim. Instances can only be
+    /// borrowed while the reclamation is deferred, so switching back to immediate waits for
+    /// the borrowed references to be destroyed, and mustn't be called while the calling
+    /// thread holds one
+    /// @param[in] reclamation When instances are released
+    /// @returns Reference to the IocContainer, for chaining operations
+    IocContainer& setReclamation(Reclamation reclamation)
+    {
+        Lock lock(mutex_);
+
+        if (reclamation == Reclamation::Deferred)
+        {
+            if (!epochs_)
+            {
+                epochs_ = std::make_unique<detail::EpochDomain>();
+            }
+
+            reclamation_ = reclamation;
+            borrowing_.store(epochs_.get(), std::memory_order_seq_cst);
+            return *this;
+        }
+
+        // Instances retired while waiting for the borrowers are still deferred
+        if (auto* epochs = borrowing_.exchange(nullptr, std::memory_order_seq_cst))
+        {
+            lock.unlock();
+            epochs->synchronize();
+            lock.lock();
+        }
+
+        if (borrowing_.load(std::memory_order_relaxed) == nullptr)
+        {
+            reclamation_ = reclamation;
+        }
+
+        return *this;
+    }
+
+    /// Releases the instances that were retired, when the reclamation is deferred. Their
+    /// destructors run on the calling thread, without the container being locked, so this
+    /// can be called from a background thread, or at a convenient point such as the end of
+    /// a frame. Waits for any borrowed references taken before the instances were retired,
+    /// so it mustn't be called while the calling thread holds a borrowed reference
+    /// @returns The number of instances that were released
+    std::size_t reclaim()
+    {
+        std::vector<Holder> retired;
+        detail::EpochDomain* epochs = nullptr;
+
+        {
+            Lock lock(mutex_);
+            retired.swap(retiredInstances_);
+            epochs = epochs_.get();
+        }
+
+        if (epochs != nullptr && !retired.empty())
+        {
+            epochs->synchronize();
+        }
+
+        const auto count = retired.size();
+        retired.clear();
+
+        return count;
+    }
+
+    /// Sets how the instances of the container are released when it is destroyed.
+    /// Sub-containers created afterwards are shut down the same way
+    /// @param[in] policy How the instances are released
+    /// @returns Reference to the IocContainer, for chaining operations
+    IocContainer& setShutdownPolicy(ShutdownPolicy policy)
+    {
+        Lock lock(mutex_);
+
+        shutdownPolicy_ = policy;
+        return *this;
+    }
+
+    /// Returns how the instances of the container are released when it is destroyed
+    ShutdownPolicy shutdownPolicy [[nodiscard]] () const
+    {
+        Lock lock(mutex_);
+
+        return shutdownPolicy_;
+    }
+
+    /// Return the size of the container. In this context, the size means the number of
+    /// instances that are held in the container
+    /// @param[in] recursive Provides a mechanism for counting the number of instances in
+    /// all subcontainers, as well
+    /// @returns The calculated size
+    /// NOTE: This calculation has a caveat. While the parent IOC container is locked, if
+    /// you are doing
+    ///     the recursive case, those will only be locked when they individually count
+    ///     their size, and so on, so it's possible that the count will not be an exact
+    ///     snapshot for that moment in time
+    std::size_t size [[nodiscard]] (bool recursive = false) const
+    {
+        Lock lock(mutex_);
+
+        std::size_t size = 0;
+
+        for (const auto& item : registeredInstances_)
+        {
+            size += item.second.size();
+        }
+
+        for (const auto& holder : unnamedInstances_)
+        {
+            size += holder.empty() ? 0 : 1;
+        }
+
+        for (const auto& item : indexedInstances_)
+        {
+            for (const auto& holder : item.second)
+            {
+                size += holder.empty() ? 0 : 1;
+            }
+        }
+
+        if (recursive)
+        {
+            auto typeName = getType(*this);
+
+            if (const Holder* holder = findInstance(typeName, NameKey()))
+            {
+                size += holder->get<IocContainer>()->size(recursive);
+            }
+
+            if (registeredInstances_.count(typeName))
+            {
+                auto& innerMap = registeredInstances_.at(typeName);
+
+                for (const auto& mapPair : innerMap)
+                {
+                    auto item = mapPair.second.value.get<IocContainer>();
+                    size += item->size(recursive);
+                }
+            }
+        }
+
+        return size;
+    }
+
+    /// Registers a default factory function for a given type. It implicitly does new T()
+    /// to create the type
+    /// @tparam T The type of the instance that will be created
+    /// @returns Reference to the IocContainer, for chaining operations
+    template <class T>
+    IocContainer& registerDefaultFactory()
+    {
+        return registerDefaultFactory<T, T>();
+    }
+
+    /// Registers a default factory function for a given type. It implicitly does new T()
+    /// to create the type
+    /// @tparam T The type of the instance that will be created
+    /// @tparam TConcrete The type of the concrete instance that will be created
+    /// @returns Reference to the IocContainer, for chaining operations
+    template <class T, class TConcrete, class... TArgs>
+    IocContainer& registerDefaultFactory()
+    {
+        return registerDefaultFactory<T, TConcrete, TArgs...>("");
+    }
+
+    /// Registers a default factory function for a given type and name. It implicitly does
+    /// new T() to create the type
+    /// @tparam T The type of the instance that will be created
+    /// @param[in] name The name of the factory
+    /// @returns Reference to the IocContainer, for chaining operations
+    template <class T>
+    IocContainer& registerDefaultFactory(NameKey name)
+    {
+        return registerDefaultFactory<T, T>(name);
+    }
+
+    /// Registers a default factory function for a given type and name. It implicitly does
+    /// new TConcrete() to create the type
+    /// @tparam T The type of the instance that will be created
+    /// @tparam TConcrete The type of the concrete instance that will be created
+    /// @param[in] name The name of the factory
+    /// @returns Reference to the IocContainer, for chaining operations
+    template <class T, class TConcrete, class... TArgs>
+    IocContainer& registerDefaultFactory(NameKey name)
+    {
+        using Invoker = FactoryInvoker<T, TArgs...>;
+
+        auto factory = [](TArgs... args) {
+            return std::make_unique<TConcrete>(std::forward<TArgs>(args)...);
+        };
+
+        auto invoker = std::make_shared<typename Invoker::Signature>(
+            Invoker::template make<std::unique_ptr<TConcrete>>(std::move(factory)));
+
+        // As the concrete type is known, createMany can construct all of the instances
+        // within a single allocation
+        if constexpr (std::is_constructible_v<TConcrete, const std::decay_t<TArgs>&...>)
+        {
+            invoker->bulk = [](std::size_t count, forwarded_arg<std::decay_t<TArgs>>... args) {
+                return InstanceGroup<T>::template make<TConcrete>(
+                    count, args.template get<const std::decay_t<TArgs>&>()...);
+            };
+        }
+
+        return registerInvoker<T>(name, std::move(invoker));
+    }
+
+    /// Registers a factory function for a given type. The factory may be a std::function,
+    /// such as Factory or SharedFactory, or any other callable with a fixed signature that
+    /// returns a unique_ptr, shared_ptr or raw pointer. Factories with different signatures
+    /// are registered side by side, as overloads, while a factory with the same signature
+    /// replaces the existing one
+    /// @tparam T The type of the instance that will be created
+    /// @param[in] factory The factory function to create the given type
+    /// @returns Reference to the IocContainer, for chaining operations
+    template <class T, class TFactory>
+    IocContainer& registerFactory(TFactory factory)
+    {
+        return registerFactory<T>("", std::move(factory));
+    }
+
+    /// Registers a factory function for a given type and name. Creating an instance by name
+    /// uses the factory registered under that name, falling back to the unnamed factory, so
+    /// a single container can create several implementations of the same type
+    /// @tparam T The type of the instance that will be created
+    /// @param[in] name The name of the factory
+    /// @param[in] factory The factory function to create the given type
+    /// @returns Reference to the IocContainer, for chaining operations
+    template <class T, class TFactory>
+    IocContainer& registerFactory(NameKey name, TFactory factory)
+    {
+        using Traits = callable_traits<TFactory>;
+        using Invoker = typename Traits::template apply_args<FactoryInvoker, T>;
+
+        auto invoker = std::make_shared<typename Invoker::Signature>(
+            Invoker::template make<typename Traits::result_type>(std::move(factory)));
+
+        return registerInvoker<T>(name, std::move(invoker));
+    }
+
+    /// Registers a factory function for a given type, along with the lifetime of the
+    /// instances which are resolved by the get methods. The factory mustn't take any
+    /// arguments. Creating an instance with create binds it in place of the lifetime
+    /// @tparam T The type of the instance that will be created
+    /// @param[in] factory The factory function to create the given type
+    /// @param[in] lifetime Which instance the get methods resolve
+    /// @returns Reference to the IocContainer, for chaining operations
+    template <class T, class TFactory>
+    IocContainer& registerFactory(TFactory factory, Lifetime lifetime)
+    {
+        return registerFactory<T>("", std::move(factory), lifetime);
+    }
+
+    /// Registers a factory function for a given type and name, along with the lifetime of
+    /// the instances which are resolved by the get methods. For a lifetime other than
+    /// Singleton, getRef resolves the instance through the binding of the type and name, so
+    /// rebinding or erasing the instance also ends that lifetime. Shared pointers to such
+    /// instances don't extend their lifetime. Per-core instances are constructed on cache
+    /// lines of their own, if the factory returns them by value, or returns a unique_ptr to
+    /// T where T can be moved and has no virtual functions. Otherwise, such as for instances
+    /// the factory shares, they remain where the factory allocated them
+    /// @tparam T The type of the instance that will be created
+    /// @param[in] name The name of the factory
+    /// @param[in] factory The factory function to create the given type
+    /// @param[in] lifetime Which instance the get methods resolve
+    /// @returns Reference to the IocContainer, for chaining operations
+    template <class T, class TFactory>
+    IocContainer& registerFactory(NameKey name, TFactory factory, Lifetime lifetime)
+    {
+        static_assert(callable_traits<TFactory>::arity == 0,
+                      "Factories with a lifetime mustn't take any arguments");
+
+        using Result = std::remove_cv_t<typename callable_traits<TFactory>::result_type>;
+
+        // Factories returning instances by value construct them in place, even if T can't be
+        // moved, which suits per-core instances such as atomic counters
+        constexpr bool byValue = std::is_same_v<Result, std::remove_cv_t<T>>;
+
+        if constexpr (byValue)
+        {
+            registerFactory<T>(name, [factory]() mutable {
+                return std::unique_ptr<T>(new T(factory()));
+            });
+        }
+        else
+        {
+            registerFactory<T>(name, factory);
+        }
+
+        auto create = [factory]() mutable {
+            if constexpr (byValue)
+            {
+                return std::shared_ptr<T>(new T(factory()));
+            }
+            else
+            {
+                return std::shared_ptr<T>(factory());
+            }
+        };
+
+        switch (lifetime)
+        {
+        case Lifetime::Singleton:
+            break;
+
+        case Lifetime::PerThread:
+            bindLifetime<T>(name,
+                            std::make_shared<ThreadLocal<T>>(std::move(create)),
+                            &resolveThreadLocal<T>);
+            break;
+
+        case Lifetime::PerCore:
+        {
+            // Only a unique_ptr is known to be the sole owner of the instance, and only a type
+            // without virtual functions is known to be exactly T, so the instance is neither
+            // taken from other owners nor sliced when it is moved into place
+            constexpr bool inPlace = byValue || (std::is_same_v<Result, std::unique_ptr<T>> &&
+                                                 !std::is_polymorphic_v<T> &&
+                                                 std::is_move_constructible_v<T>);
+
+            bindLifetime<T>(name,
+                            std::make_shared<Replicas<T>>(
+                                std::max(std::thread::hardware_concurrency(), 1u),
+                                &detail::currentCpu,
+                                [factory, create](std::size_t, void* storage) mutable {
+                                    if constexpr (inPlace)
+                                    {
+                                        return constructReplica<T, byValue>(storage, factory);
+                                    }
+                                    else
+                                    {
+                                        return create();
+                                    }
+                                },
+                                inPlace),
+                            &resolveReplica<T>);
+            break;
+        }
+
+        case Lifetime::PerNumaNode:
+        {
+            auto topology = numaTopology();
+
+            bindLifetime<T>(name,
+                            std::make_shared<Replicas<T>>(
+                                topology->nodeCount(),
+                                [topology] { return topology->currentNode(); },
+                                [topology, create](std::size_t node, void*) mutable {
+                                    return createOnNode(*topology, node, create);
+                                },
+                                false),
+                            &resolveReplica<T>);
+            break;
+        }
+        }
+
+        return *this;
+    }
+
+    /// Sets the NUMA topology, which instances registered with a per-node lifetime
+    /// afterwards are replicated across. By default, this is the topology of the machine
+    /// @param[in] topology The NUMA topology
+    /// @returns Reference to the IocContainer, for chaining operations
+    IocContainer& setNumaTopology(std::shared_ptr<const NumaTopology> topology)
+    {
+        Lock lock(mutex_);
+
+        numaTopology_ = std::move(topology);
+        return *this;
+    }
+
+    /// Calls a function with each of the instances of a type with a per-core or per-node
+    /// lifetime, such as to aggregate counters. Only the instances which were created are
+    /// visited
+    /// @tparam T The type of the instances
+    /// @param[in] func The function, which is called with a reference to each instance
+    /// @throws IocException if the type wasn't registered with a per-core or per-node
+    /// lifetime
+    template <class T, class TFunc>
+    void forEachReplica(TFunc func) const
+    {
+        forEachReplica<T>(NameKey(), std::move(func));
+    }
+
+    /// Calls a function with each of the instances of a type and name with a per-core or
+    /// per-node lifetime. Only the instances which were created are visited
+    /// @tparam T The type of the instances
+    /// @param[in] name The name of the instances
+    /// @param[in] func The function, which is called with a reference to each instance
+    /// @throws IocException if the type wasn't registered with a per-core or per-node
+    /// lifetime
+    template <class T, class TFunc>
+    void forEachReplica(NameKey name, TFunc func) const
+    {
+        // Visit the instances without the container locked, as they are kept by the replicas
+        getReplicas<T>(name)->forEach(std::move(func));
+    }
+
+    /// Returns the replicas of a type and name with a per-core or per-node lifetime. Callers
+    /// can hold on to them, and find the instance for the calling thread with local without
+    /// locking the container, unlike getRef. The replicas remain valid after the binding is
+    /// erased or replaced, although the container no longer resolves them
+    /// @tparam T The type of the instances
+    /// @param[in] name The name of the instances
+    /// @returns The replicas
+    /// @throws IocException if the type wasn't registered with a per-core or per-node
+    /// lifetime
+    template <class T>
+    std::shared_ptr<Replicas<T>> getReplicas [[nodiscard]] (NameKey name = NameKey()) const
+    {
+        return getLifetime<T, Replicas<T>>(name, "replicas");
+    }
+
+    /// Calls a function with each of the instances of a type with a per-core or per-node
+    /// lifetime, see forEachReplica. Unlike forEachReplica, failures are returned rather than
+    /// raised
+    /// @tparam T The type of the instances
+    /// @param[in] func The function, which is called with a reference to each instance
+    /// @returns ErrorCode::None, or ErrorCode::NotFound if the type wasn't registered with a
+    /// per-core or per-node lifetime
+    template <class T, class TFunc>
+    ErrorCode tryForEachReplica [[nodiscard]] (TFunc func) const
+    {
+        return tryForEachReplica<T>(NameKey(), std::move(func));
+    }
+
+    /// Calls a function with each of the instances of a type and name with a per-core or
+    /// per-node lifetime, see forEachReplica. Unlike forEachReplica, failures are returned
+    /// rather than raised
+    /// @tparam T The type of the instances
+    /// @param[in] name The name of the instances
+    /// @param[in] func The function, which is called with a reference to each instance
+    /// @returns ErrorCode::None, or ErrorCode::NotFound if the type wasn't registered with a
+    /// per-core or per-node lifetime
+    template <class T, class TFunc>
+    ErrorCode tryForEachReplica [[nodiscard]] (NameKey name, TFunc func) const
+    {
+        auto replicas = tryGetReplicas<T>(name);
+
+        if (!replicas)
+        {
+            return replicas.error();
+        }
+
+        (*replicas)->forEach(std::move(func));
+        return ErrorCode::None;
+    }
+
+    /// Returns the replicas of a type and name with a per-core or per-node lifetime, see
+    /// getReplicas. Unlike getReplicas, failures are returned rather than raised
+    /// @tparam T The type of the instances
+    /// @param[in] name The name of the instances
+    /// @returns The replicas, or ErrorCode::NotFound if the type wasn't registered with a
+    /// per-core or per-node lifetime
+    template <class T>
+    Result<std::shared_ptr<Replicas<T>>> tryGetReplicas
+        [[nodiscard]] (NameKey name = NameKey()) const
+    {
+        Lock lock(mutex_);
+        return lookupLifetime<T, Replicas<T>>(name);
+    }
+
+    /// Returns the instances of a type and name with a per-thread lifetime. Callers can hold
+    /// on to them, and find the instance of the calling thread with local, through a
+    /// thread-local slot and without locking the container, unlike getRef. The instances
+    /// remain valid after the binding is erased or replaced, although the container no
+    /// longer resolves them
+    /// @tparam T The type of the instances
+    /// @param[in] name The name of the instances
+    /// @returns The instances
+    /// @throws IocException if the type wasn't registered with a per-thread lifetime
+    template <class T>
+    std::shared_ptr<ThreadLocal<T>> getThreadLocal [[nodiscard]] (NameKey name = NameKey()) const
+    {
+        return getLifetime<T, ThreadLocal<T>>(name, "per-thread instances");
+    }
+
+    /// Returns the instances of a type and name with a per-thread lifetime, see
+    /// getThreadLocal. Unlike getThreadLocal, failures are returned rather than raised
+    /// @tparam T The type of the instances
+    /// @param[in] name The name of the instances
+    /// @returns The instances, or ErrorCode::NotFound if the type wasn't registered with a
+    /// per-thread lifetime
+    template <class T>
+    Result<std::shared_ptr<ThreadLocal<T>>> tryGetThreadLocal
+        [[nodiscard]] (NameKey name = NameKey()) const
+    {
+        Lock lock(mutex_);
+        return lookupLifetime<T, ThreadLocal<T>>(name);
+    }
+
+    /// Registers a memoizing factory for a given type. The arguments of each creation are
+    /// hashed, and repeated creations with equal arguments return the same shared instance
+    /// instead of constructing a new one. The arguments must be hashable with std::hash and
+    /// equality comparable
+    /// @tparam T The type of the instance that will be created
+    /// @tparam TArgs The arguments that instances are created from and cached by
+    /// @param[in] factory The factory function, invoked with const references to the
+    /// arguments on a cache miss
+    /// @param[in] capacity The maximum number of instances that are cached
+    /// @param[in] policy Which cached instance to discard once the cache is at capacity
+    /// @returns Reference to the IocContainer, for chaining operations
+    template <class T, class... TArgs, class TFactory>
+    IocContainer& registerMemoizedFactory(TFactory factory,
+                                          std::size_t capacity,
+                                          EvictionPolicy policy = EvictionPolicy::LeastRecentlyUsed)
+    {
+        return registerMemoizedFactory<T, TArgs...>("", std::move(factory), capacity, policy);
+    }
+
+    /// Registers a memoizing factory for a given type and name. The arguments of each
+    /// creation are hashed, and repeated creations with equal arguments return the same
+    /// shared instance instead of constructing a new one. The arguments must be hashable
+    /// with std::hash and equality comparable
+    /// @tparam T The type of the instance that will be created
+    /// @tparam TArgs The arguments that instances are created from and cached by
+    /// @param[in] name The name of the factory
+    /// @param[in] factory The factory function, invoked with const references to the
+    /// arguments on a cache miss
+    /// @param[in] capacity The maximum number of instances that are cached
+    /// @param[in] policy Which cached instance to discard once the cache is at capacity
+    /// @returns Reference to the IocContainer, for chaining operations
+    template <class T, class... TArgs, class TFactory>
+    IocContainer& registerMemoizedFactory(NameKey name,
+                                          TFactory factory,
+                                          std::size_t capacity,
+                                          EvictionPolicy policy = EvictionPolicy::LeastRecentlyUsed)
+    {
+        using Cache = MemoizedCache<T, std::decay_t<TArgs>...>;
+        using Invoker = FactoryInvoker<T, const std::decay_t<TArgs>&...>;
+
+        auto cache = std::make_shared<Cache>(std::move(factory), capacity, policy);
+        auto memoized = [cache](const std::decay_t<TArgs>&... args) {
+            return cache->get(args...);
+        };
+
+        auto invoker = std::make_shared<typename Invoker::Signature>(
+            Invoker::template make<std::shared_ptr<T>>(std::move(memoized)));
+        invoker->cache = std::move(cache);
+
+        return registerInvoker<T>(name, std::move(invoker));
+    }
+
+    /// Returns the statistics of a memoizing factory
+    /// @tparam T The type of the instance that the factory creates
+    /// @tparam TArgs The arguments that the factory was registered with
+    /// @returns The statistics of the cache of the factory
+    /// @throws IocException If there is no memoizing factory with that signature
+    template <class T, class... TArgs>
+    MemoizationStats memoizationStats [[nodiscard]] () const
+    {
+        return memoizationStats<T, TArgs...>("");
+    }
+
+    /// Returns the statistics of a memoizing factory
+    /// @tparam T The type of the instance that the factory creates
+    /// @tparam TArgs The arguments that the factory was registered with
+    /// @param[in] name The name of the factory
+    /// @returns The statistics of the cache of the factory
+    /// @throws IocException If there is no memoizing factory with that signature
+    template <class T, class... TArgs>
+    MemoizationStats memoizationStats [[nodiscard]] (NameKey name) const
+    {
+        using detail::format;
+        using detail::str;
+
+        auto invoker = findFactory<T, TArgs...>(name);
+
+        if (!invoker->cache)
+        {
+            static const format fmt("Factory is not memoized.\n\tFactory: %1%\n\tName   : %2%");
+            CPPINVERT_RAISE(
+                ErrorCode::NotMemoized,
+                str(format(fmt) % getType<decltype(*invoker)>().name() % name.str()));
+        }
+
+        return invoker->cache->stats();
+    }
+
+    /// Returns the statistics of a memoizing factory, see memoizationStats. Unlike
+    /// memoizationStats, failures are returned rather than raised
+    /// @tparam T The type of the instance that the factory creates
+    /// @tparam TArgs The arguments that the factory was registered with
+    /// @param[in] name The name of the factory
+    /// @returns The statistics, or the error of the factory lookup, or
+    /// ErrorCode::NotMemoized if the factory isn't memoized
+    template <class T, class... TArgs>
+    Result<MemoizationStats> tryMemoizationStats [[nodiscard]] (NameKey name = NameKey()) const
+    {
+        auto invoker = lookupFactory<T, TArgs...>(name);
+
+        if (!invoker)
+        {
+            return invoker.error();
+        }
+
+        if (!(*invoker)->cache)
+        {
+            return ErrorCode::NotMemoized;
+        }
+
+        return (*invoker)->cache->stats();
+    }
+
+    /// Registers an instance for a given type. This version performs a copy of the
+    /// object, using the copy
+    ///     constructor and will manage lifetime via the Holder (shared_ptr)
+    /// @tparam T The type of the instance
+    /// @param[in] instance The instance to be held within the container
+    /// @returns Reference to the IocContainer, for chaining operations
+    template <class T>
+    IocContainer& bindValue(value_wrapper<T> instance)
+    {
+        return bindValue<T>("", std::move(instance));
+    }
+
+    /// Registers an instance for a given type. This version performs a copy of the
+    /// object, using the copy
+    ///     constructor and will manage lifetime via the Holder (shared_ptr)
+    /// @tparam T The type of the instance
+    /// @param[in] instance The instance to be held within the container
+    /// @returns Reference to the IocContainer, for chaining operations
+    template <class T>
+    std::enable_if_t<!is_wrapped_v<T>, IocContainer&> bindValue(T instance)
+    {
+        return bindValue<T>("", std::move(instance));
+    }
+
+    /// Registers an instance for a given type. This version refers to the object and will
+    /// not manage lifetime
+    ///     as the shared_ptr will have a null deleter. To call this, use:
+    ///     bindInstance(std::ref(instance)) or bindInstance(std:::cref(instance))
+    /// @tparam T The type of the instance
+    /// @param[in] instance The instance to be held within the container
+    /// @returns Reference to the IocContainer, for chaining operations
+    template <class T>
+    IocContainer& bindInstance(std::reference_wrapper<T> instance)
+    {
+        return bindInstance<T>("", instance);
+    }
+
+#if 0
+    /// Registers an instance for a given type. This version performs a copy of the
+    /// object, using the copy
+    ///     constructor and will manage lifetime via the Holder (shared_ptr)
+    /// @tparam T The type of the instance
+    /// @param[in] instance The instance to be held within the container
+    /// @returns Reference to the IocContainer, for chaining operations
+    // template <class T, typename std::enable_if_t<!is_wrapped_v<T>, T>* = nullptr>
+    template <class T>
+    IocContainer& bindInstance(T instance)
+    {
+        return bindInstance<T>("", std::move(instance));
+    }
+#endif
+
+    /// Registers an instance for a given type. This version refers to the object and will
+    /// not manage lifetime
+    ///     as the shared_ptr will have a null deleter. To call this, use:
+    ///     bindInstance(std::ref(instance)) or bindInstance(std:::cref(instance))
+    /// @tparam TBase The type of the instance
+    /// @tparam TDerived The type of the instance
+    /// @param[in] instance The instance to be held within the container
+    /// @returns Reference to the IocContainer, for chaining operations
+    template <class TBase,
+              class TDerived,
+              typename std::enable_if_t<!std::is_same_v<TBase, TDerived>, TDerived>* = nullptr>
+    IocContainer& bindInstance(std::reference_wrapper<TDerived> instance)
+    {
+        return bindInstance<TBase, TDerived>("", instance);
+    }
+
+    /// Registers an instance for a given type. This version refers to a pointer to be
+    /// held within the container
+    ///     and does not manage lifetime. If you want to manage lifetime, please see the
+    ///     unique_ptr or shared_ptr versions
+    /// @tparam T The type of the instance
+    /// @param[in] instance The instance to be held within the container
+    /// @returns Reference to the IocContainer, for chaining operations
+    template <class T>
+    IocContainer& bindInstance(T* instance)
+    {
+        return bindInstance<T>("", instance);
+    }
+
+    /// Registers an instance for a given type. This version will take in a unique_ptr,
+    /// take ownership and manage
+    ///     lifetime via a Holder (shared_ptr)
+    /// @tparam T The type of the instance
+    /// @param[in] instance The instance to be held within the container
+    /// @returns Reference to the IocContainer, for chaining operations
+    template <class T>
+    IocContainer& bindInstance(std::unique_ptr<T> instance)
+    {
+        return bindInstance<T>("", instance);
+    }
+
+    /// Registers an instance for a given type. This version will take in a shared_ptr and
+    /// share lifetime with
+    //      any other shared_ptrs that reference it
+    /// @tparam T The type of the instance
+    /// @param[in] instance The instance to be held within the container
+    /// @returns Reference to the IocContainer, for chaining operations
+    template <class T>
+    IocContainer& bindInstance(std::shared_ptr<T> instance)
+    {
+        return bindInstance<T>("", instance);
+    }
+
+    /// Registers an instance for a given type. This version performs a copy of the
+    /// object, using the copy
+    ///     constructor and will manage lifetime via the Holder (shared_ptr)
+    /// @tparam T The type of the instance
+    /// @param[in] name The name of the instance
+    /// @param[in] instance The instance to be held within the container
+    /// @returns Reference to the IocContainer, for chaining operations
+    template <class T>
+    IocContainer& bindInstance(NameKey name, std::reference_wrapper<T> instance)
+    {
+        return bindInstanceInternal<T>(name, HolderPtr<T>{&instance.get(), nullDeleter_v<T>});
+    }
+
+#if 0
+    /// Registers an instance for a given type. This version performs a copy of the
+    /// object, using the copy
+    ///     constructor and will manage lifetime via the Holder (shared_ptr)
+    /// @tparam T The type of the instance
+    /// @param[in] name The name of the instance
+    /// @param[in] instance The instance to be held within the container
+    /// @returns Reference to the IocContainer, for chaining operations
+    // template <class T, typename std::enable_if_t<!is_wrapped_v<T>, T>* = nullptr>
+    template <class T>
+    IocContainer& bindInstance(NameKey name, T instance)
+    {
+        return bindValue(name, value_wrapper<T>{std::move(instance)});
+    }
+#endif
+
+    /// Registers an instance for a given type. This version performs a copy of the
+    /// object, using the copy
+    ///     constructor and will manage lifetime via the Holder (shared_ptr)
+    /// @tparam TBase The base type of the instance
+    /// @tparam TDerived The type of the instance
+    /// @param[in] name The name of the instance
+    /// @param[in] instance The instance to be held within the container
+    /// @returns Reference to the IocContainer, for chaining operations
+    template <class TBase,
+              class TDerived,
+              typename std::enable_if_t<!std::is_same_v<TBase, TDerived>, TDerived>* = nullptr>
+    IocContainer& bindInstance(NameKey name, std::reference_wrapper<TDerived> instance)
+    {
+        return bindInstanceInternal<TBase>(name,
+                                           HolderPtr<TBase>{&instance.get(), nullDeleter_v<TBase>});
+    }
+
+    /// Registers an instance for a given type. This version performs a copy of the
+    /// object, using the copy
+    ///     constructor and will manage lifetime via the Holder (shared_ptr)
+    /// @tparam T The type of the instance
+    /// @param[in] name The name of the instance
+    /// @param[in] instance The instance to be held within the container
+    /// @returns Reference to the IocContainer, for chaining operations
+    template <class T>
+    IocContainer& bindInstance(NameKey name, T* instance)
+    {
+        return bindInstanceInternal<T>(name, HolderPtr<T>(instance, nullDeleter_v<T>));
+    }
+
+    /// Registers an instance for a given type. This version will take in a unique_ptr,
+    /// take ownership and manage
+    ///     lifetime via a Holder (shared_ptr)
+    /// @tparam T The type of the instance
+    /// @param[in] name The name of the instance
+    /// @param[in] instance The instance to be held within the container
+    /// @returns Reference to the IocContainer, for chaining operations
+    template <class T>
+    IocContainer& bindInstance(NameKey name, std::unique_ptr<T> instance)
+    {
+        return bindInstanceInternal<T>(name, std::move(instance));
+    }
+
+    /// Registers an instance for a given type. This version will take in a shared_ptr and
+    /// share lifetime with any other shared_ptrs that reference it
+    /// @tparam T The type of the instance
+    /// @param[in] name The name of the instance
+    /// @param[in] instance The instance to be held within the container
+    /// @returns Reference to the IocContainer, for chaining operations
+    template <class T>
+    IocContainer& bindInstance(NameKey name, std::shared_ptr<T> instance)
+    {
+        return bindInstanceInternal<T>(name, std::move(instance));
+    }
+
+    /// Registers an instance, which can be retrieved as its own type, or as any of the
+    /// declared interfaces, e.g. bindInstance(duck, implements<IFly, IQuack>())
+    /// @tparam TInstance The instance, which is a reference_wrapper, pointer, unique_ptr or
+    /// shared_ptr, as for the other versions of bindInstance
+    /// @tparam TBases The base classes the instance can be retrieved as
+    /// @param[in] instance The instance to be held within the container
+    /// @param[in] bases The base classes the instance can be retrieved as
+    /// @returns Reference to the IocContainer, for chaining operations
+    template <class TInstance, class... TBases>
+    IocContainer& bindInstance(TInstance instance, implements<TBases...> bases)
+    {
+        return bindInstance(NameKey(), std::move(instance), bases);
+    }
+
+    /// Registers an instance, which can be retrieved as its own type, or as any of the
+    /// declared interfaces. The instance is held in a single slot, which each of the types
+    /// links to, along with the conversion of the pointer to that type. So retrieving the
+    /// instance as an interface is a single lookup, and rebinding the instance as its own
+    /// type replaces it for every interface. Binding one of the interfaces separately
+    /// replaces just that interface
+    /// @tparam TInstance The instance, which is a reference_wrapper, pointer, unique_ptr or
+    /// shared_ptr, as for the other versions of bindInstance
+    /// @tparam TBases The base classes the instance can be retrieved as
+    /// @param[in] name The name of the instance
+    /// @param[in] instance The instance to be held within the container
+    /// @returns Reference to the IocContainer, for chaining operations
+    template <class TInstance, class... TBases>
+    IocContainer& bindInstance(NameKey name, TInstance instance, implements<TBases...>)
+    {
+        auto holderPtr = toHolderPtr(std::move(instance));
+        using T = typename decltype(holderPtr)::element_type;
+
+        static_assert((std::is_base_of_v<TBases, T> && ...),
+                      "The instance must derive from each of the declared interfaces");
+
+        auto slot = std::make_shared<Holder>(std::move(holderPtr));
+
+        Lock lock(mutex_);
+
+        bindInstanceInternal(getType<T>(), name, Holder::makeLink<T, T>(slot));
+        (bindInstanceInternal(getType<TBases>(), name, Holder::makeLink<TBases, T>(slot)), ...);
+        return *this;
+    }
+
+    /// Registers an instance for a given type. This version performs a copy of the
+    /// object, using the copy
+    ///     constructor and will manage lifetime via the Holder (shared_ptr)
+    /// @tparam T The type of the instance
+    /// @param[in] name The name of the instance
+    /// @param[in] instance The instance to be held within the container
+    /// @returns Reference to the IocContainer, for chaining operations
+    template <class T>
+    std::enable_if_t<!is_reference_wrapper_v<T>, IocContainer&> bindValue(NameKey name,
+                                                                          value_wrapper<T> instance)
+    {
+        return emplace<T>(name, instance.move());
+    }
+
+    /// Registers an instance for a given type. This version performs a copy of the
+    /// object, using the copy
+    ///     constructor and will manage lifetime via the Holder (shared_ptr)
+    /// @tparam T The type of the instance
+    /// @param[in] name The name of the instance
+    /// @param[in] instance The instance to be held within the container
+    /// @returns Reference to the IocContainer, for chaining operations
+    template <class T>
+    std::enable_if_t<!is_wrapped_v<T>, IocContainer&> bindValue(NameKey name, T instance)
+    {
+        return emplace<T>(name, std::move(instance));
+    }
+
+    /// Constructs an instance of the given type directly within the container, so the
+    /// object is never copied or moved. The instance and its reference count share a single
+    /// allocation, while small trivially copyable values are stored inline without any
+    /// allocation at all. The slot is reserved while the instance is constructed, and is
+    /// released again if construction throws
+    /// @tparam T The type of the instance
+    /// @param[in] name The name of the instance
+    /// @param[in] args The arguments to pass to the constructor of the instance
+    /// @returns Reference to the IocContainer, for chaining operations
+    template <class T, class... TArgs>
+    IocContainer& emplace(NameKey name, TArgs&&... args)
+    {
+        Lock lock(mutex_);
+
+        const auto typeName = getType<T>();
+        auto [holder, inserted] = reserveInstance(typeName, name);
+
+        SlotReservation reservation{*this, typeName, name, inserted};
+        retire(holder->template emplace<T>(std::forward<TArgs>(args)...));
+        reservation.release = false;
+        recordCreation(*holder);
+
+        return *this;
+    }
+
+    /// Replaces an instance which may be in use by other threads, without blocking them.
+    /// Readers get the Swappable of the instance once, with getSwappable, and then load the
+    /// current instance from it without locking the container. Readers that loaded the
+    /// previous instance keep it until they drop it. The first swap creates the Swappable.
+    /// The instance is also bound as T under the name, in place of any instance bound there
+    /// already, so that readers which get it from the container see it as well
+    /// @tparam T The type of the instance
+    /// @param[in] name The name of the instance
+    /// @param[in] instance The new instance
+    /// @returns Reference to the IocContainer, for chaining operations
+    template <class T>
+    IocContainer& swap(NameKey name, std::shared_ptr<T> instance)
+    {
+        Lock lock(mutex_);
+
+        bindInstanceInternal<T>(name, instance);
+
+        const auto typeName = getType<Swappable<T>>();
+        const Holder* holder = findInstance(typeName, name);
+
+        if (holder == nullptr)
+        {
+            return bindInstanceInternal(
+                typeName, name, Holder(std::make_shared<Swappable<T>>(std::move(instance))));
+        }
+
+        auto previous = holder->template get<Swappable<T>>()->exchange(std::move(instance));
+
+        if (previous)
+        {
+            retire(Holder(previous));
+        }
+
+        // Unless the reclamation is deferred, the container holds the last reference to the
+        // previous instance, which is released once the container is unlocked
+        lock.unlock();
+        return *this;
+    }
+
+    /// Replaces an unnamed instance which may be in use by other threads, see swap
+    /// @tparam T The type of the instance
+    /// @param[in] instance The new instance
+    /// @returns Reference to the IocContainer, for chaining operations
+    template <class T>
+    IocContainer& swap(std::shared_ptr<T> instance)
+    {
+        return swap<T>(NameKey(), std::move(instance));
+    }
+
+    /// Returns the Swappable of an instance that is replaced with swap. Readers can hold on
+    /// to it, and load the current instance without locking the container
+    /// @tparam T The type of the instance
+    /// @param[in] name The name of the instance
+    /// @returns The Swappable of the instance
+    /// @throws IocException if the instance was never swapped in
+    template <class T>
+    std::shared_ptr<Swappable<T>> getSwappable [[nodiscard]] (NameKey name = NameKey()) const
+    {
+        return getShared<Swappable<T>>(name);
+    }
+
+    /// Returns the Swappable of an instance that is replaced with swap. Unlike getSwappable,
+    /// failures are returned rather than raised
+    /// @tparam T The type of the instance
+    /// @param[in] name The name of the instance
+    /// @returns The Swappable, or ErrorCode::NotFound if the instance was never swapped in
+    template <class T>
+    Result<std::shared_ptr<Swappable<T>>> tryGetSwappable
+        [[nodiscard]] (NameKey name = NameKey()) const
+    {
+        return tryGetShared<Swappable<T>>(name);
+    }
+
+    /// Utility method to erase an existing instance from the container
+    /// @tparam T The type of the instance
+    /// @returns Reference to the IocContainer, for chaining operations
+    template <class T>
+    IocContainer& eraseInstance()
+    {
+        return eraseInstance<T>("");
+    }
+
+    /// Utility method to erase an existing instance from the container
+    /// @tparam T The type of the instance
+    /// @param[in] name The name of the instance
+    /// @returns Reference to the IocContainer, for chaining operations
+    template <class T>
+    IocContainer& eraseInstance(NameKey name)
+    {
+        return eraseInstanceInternal(getType<T>(), name);
+    }
+
+    /// Registers another name for an existing instance. The alias shares the slot of the
+    /// instance, rather than holding a copy, so rebinding the instance under either name
+    /// replaces it for both. Erasing either name leaves the other intact
+    /// @tparam T The type of the instance
+    /// @param[in] name The name of the alias
+    /// @param[in] existingName The name the instance is registered under
+    /// @returns Reference to the IocContainer, for chaining operations
+    /// @throws IocException if no instance of the type is registered under existingName
+    template <class T>
+    IocContainer& alias(NameKey name, NameKey existingName)
+    {
+        using detail::format;
+        using detail::str;
+
+        const auto error = tryAlias<T>(name, existingName);
+
+        if (error != ErrorCode::None)
+        {
+            static const format fmt("Item not found by type and name. \n\tExpected "
+                                    "Holder Type:  %1%\n\tName                : %2%");
+            CPPINVERT_RAISE(error, str(format(fmt) % getType<T>().name() % existingName.str()));
+        }
+
+        return *this;
+    }
+
+    /// Registers another name for an existing instance, see alias. Unlike alias, failures
+    /// are returned rather than raised
+    /// @tparam T The type of the instance
+    /// @param[in] name The name of the alias
+    /// @param[in] existingName The name the instance is registered under
+    /// @returns ErrorCode::None, or ErrorCode::NotFound if no instance of the type is
+    /// registered under existingName
+    template <class T>
+    ErrorCode tryAlias [[nodiscard]] (NameKey name, NameKey existingName)
+    {
+        Lock lock(mutex_);
+
+        const auto typeName = getType<T>();
+
+        if (findInstance(typeName, existingName) == nullptr)
+        {
+            return ErrorCode::NotFound;
+        }
+
+        // Move the instance into a slot of its own, the first time it is aliased
+        Holder& existing = *reserveInstance(typeName, existingName).first;
+
+        if (!existing.linked())
+        {
+            existing = Holder::makeLink<T, T>(std::make_shared<Holder>(std::move(existing)));
+        }
+
+        Holder link = existing;
+        retire(reserveInstance(typeName, name).first->assign(std::move(link)));
+        return ErrorCode::None;
+    }
+
+    /// Registers an instance for a given type, distinguished by a tag type rather than a
+    /// name. The key is derived from the type and the tag at compile time, so tagged
+    /// bindings involve no names at all, e.g. bindInstance<Logger, AuditTag>(logger)
+    /// @tparam T The type of the instance
+    /// @tparam Tag An empty class, which identifies the binding
+    /// @param[in] instance The instance to be held within the container
+    /// @returns Reference to the IocContainer, for chaining operations
+    template <class T, class Tag, std::enable_if_t<is_tag_v<T, Tag>>* = nullptr>
+    IocContainer& bindInstance(std::reference_wrapper<T> instance)
+    {
+        return bindInstanceInternal(
+            getType<T, Tag>(), NameKey(), Holder(HolderPtr<T>{&instance.get(), nullDeleter_v<T>}));
+    }
+
+    /// Registers an instance for a given type and tag, without taking ownership of it
+    /// @tparam T The type of the instance
+    /// @tparam Tag An empty class, which identifies the binding
+    /// @param[in] instance The instance to be held within the container
+    /// @returns Reference to the IocContainer, for chaining operations
+    template <class T, class Tag, std::enable_if_t<is_tag_v<T, Tag>>* = nullptr>
+    IocContainer& bindInstance(T* instance)
+    {
+        return bindInstanceInternal(
+            getType<T, Tag>(), NameKey(), Holder(HolderPtr<T>(instance, nullDeleter_v<T>)));
+    }
+
+    /// Registers an instance for a given type and tag. This version will take ownership of
+    /// the instance
+    /// @tparam T The type of the instance
+    /// @tparam Tag An empty class, which identifies the binding
+    /// @param[in] instance The instance to be held within the container
+    /// @returns Reference to the IocContainer, for chaining operations
+    template <class T, class Tag, std::enable_if_t<is_tag_v<T, Tag>>* = nullptr>
+    IocContainer& bindInstance(std::unique_ptr<T> instance)
+    {
+        return bindInstanceInternal(
+            getType<T, Tag>(), NameKey(), Holder(HolderPtr<T>(std::move(instance))));
+    }
+
+    /// Registers an instance for a given type and tag. This version will share lifetime
+    /// with any other shared_ptrs that reference it
+    /// @tparam T The type of the instance
+    /// @tparam Tag An empty class, which identifies the binding
+    /// @param[in] instance The instance to be held within the container
+    /// @returns Reference to the IocContainer, for chaining operations
+    template <class T, class Tag, std::enable_if_t<is_tag_v<T, Tag>>* = nullptr>
+    IocContainer& bindInstance(std::shared_ptr<T> instance)
+    {
+        return bindInstanceInternal(getType<T, Tag>(), NameKey(), Holder(std::move(instance)));
+    }
+
+    /// Utility method to erase an existing tagged instance from the container
+    /// @tparam T The type of the instance
+    /// @tparam Tag The tag of the instance
+    /// @returns Reference to the IocContainer, for chaining operations
+    template <class T, class Tag, std::enable_if_t<is_tag_v<T, Tag>>* = nullptr>
+    IocContainer& eraseInstance()
+    {
+        return eraseInstanceInternal(getType<T, Tag>(), NameKey());
+    }
+
+    /// Registers an instance for a given type under an integer index. Indexed instances
+    /// are held in a dense array per type, so they are an alternative to building names
+    /// such as "viewport3", which avoids formatting and hashing strings. They are held
+    /// alongside, and independently of, the named instances
+    /// @tparam T The type of the instance
+    /// @param[in] index The index of the instance
+    /// @param[in] instance The instance to be held within the container
+    /// @returns Reference to the IocContainer, for chaining operations
+    template <class T>
+    IocContainer& bindIndexed(std::size_t index, std::reference_wrapper<T> instance)
+    {
+        return bindIndexedInternal(
+            getType<T>(), index, Holder(HolderPtr<T>{&instance.get(), nullDeleter_v<T>}));
+    }
+
+    /// Registers an instance for a given type under an integer index, without taking
+    /// ownership of it
+    /// @tparam T The type of the instance
+    /// @param[in] index The index of the instance
+    /// @param[in] instance The instance to be held within the container
+    /// @returns Reference to the IocContainer, for chaining operations
+    template <class T>
+    IocContainer& bindIndexed(std::size_t index, T* instance)
+    {
+        return bindIndexedInternal(
+            getType<T>(), index, Holder(HolderPtr<T>(instance, nullDeleter_v<T>)));
+    }
+
+    /// Registers an instance for a given type under an integer index. This version will
+    /// take ownership of the instance
+    /// @tparam T The type of the instance
+    /// @param[in] index The index of the instance
+    /// @param[in] instance The instance to be held within the container
+    /// @returns Reference to the IocContainer, for chaining operations
+    template <class T>
+    IocContainer& bindIndexed(std::size_t index, std::unique_ptr<T> instance)
+    {
+        return bindIndexedInternal(getType<T>(), index, Holder(HolderPtr<T>(std::move(instance))));
+    }
+
+    /// Registers an instance for a given type under an integer index. This version will
+    /// share lifetime with any other shared_ptrs that reference it
+    /// @tparam T The type of the instance
+    /// @param[in] index The index of the instance
+    /// @param[in] instance The instance to be held within the container
+    /// @returns Reference to the IocContainer, for chaining operations
+    template <class T>
+    IocContainer& bindIndexed(std::size_t index, std::shared_ptr<T> instance)
+    {
+        return bindIndexedInternal(getType<T>(), index, Holder(std::move(instance)));
+    }
+
+    /// Utility method to erase an existing indexed instance from the container
+    /// @tparam T The type of the instance
+    /// @param[in] index The index of the instance
+    /// @returns Reference to the IocContainer, for chaining operations
+    template <class T>
+    IocContainer& eraseInstance(std::size_t index)
+    {
+        Lock lock(mutex_);
+
+        auto iter = indexedInstances_.find(getType<T>());
+
+        if (iter != indexedInstances_.end() && index < iter->second.size())
+        {
+            auto& instances = iter->second;
+            retire(std::exchange(instances[index], Holder()));
+
+            // Trim the trailing gaps, and the whole array once nothing is left
+            while (!instances.empty() && instances.back().empty())
+            {
+                instances.pop_back();
+            }
+
+            if (instances.empty())
+            {
+                indexedInstances_.erase(iter);
+            }
+        }
+
+        return *this;
+    }
+
+    /// Creates an instance using a registered factory
+    /// @tparam T The type of the instance
+    /// @returns Reference to the IocContainer, for chaining operations
+    /// @throws IocException If object is not contained within the container and there is
+    /// no factory
+    ///     registered to create it
+    template <class T, class... TArgs>
+    std::unique_ptr<T> createWithoutStoring [[nodiscard]] (TArgs&&... args)
+    {
+        return createByNameWithoutStoring<T>("", std::forward<TArgs>(args)...);
+    }
+
+    /// Creates an instance using a registered factory and assign it the specified name
+    /// @tparam T The type of the instance
+    /// @returns Reference to the IocContainer, for chaining operations
+    /// @throws IocException If object is not contained within the container and there is
+    /// no factory
+    ///     registered to create it
+    template <class T, class... TArgs>
+    std::unique_ptr<T> createByNameWithoutStoring
+        [[nodiscard]] (NameKey name, TArgs&&... args)
+    {
+        using detail::format;
+        using detail::str;
+
+        auto invoker = findFactory<T, TArgs...>(name);
+
+        if (!invoker->unique)
+        {
+            static const format fmt("Shared factory cannot return a unique ptr, "
+                                    "please use createByNameWithoutStoringShared instead."
+                                    "\n\tFactory: %1%");
+            CPPINVERT_RAISE(ErrorCode::SharedOnlyFactory,
+                            str(format(fmt) % getType<decltype(*invoker)>().name()));
+        }
+
+        return invoker->unique(forwarded_arg<std::decay_t<TArgs>>(std::forward<TArgs>(args))...);
+    }
+
+    /// Creates an instance using a registered factory
+    /// @tparam T The type of the instance
+    /// @returns Reference to the IocContainer, for chaining operations
+    /// @throws IocException If object is not contained within the container and there is
+    /// no factory
+    ///     registered to create it
+    template <class T, class... TArgs>
+    std::shared_ptr<T> createWithoutStoringShared [[nodiscard]] (TArgs&&... args)
+    {
+        return createByNameWithoutStoringShared<T>("", std::forward<TArgs>(args)...);
+    }
+
+    /// Creates an instance using a registered factory and assign it the specified name
+    /// @tparam T The type of the instance
+    /// @returns Reference to the IocContainer, for chaining operations
+    /// @throws IocException If object is not contained within the container and there is
+    /// no factory
+    ///     registered to create it
+    template <class T, class... TArgs>
+    std::shared_ptr<T> createByNameWithoutStoringShared
+        [[nodiscard]] (NameKey name, TArgs&&... args)
+    {
+        return findFactory<T, TArgs...>(name)->createShared(std::forward<TArgs>(args)...);
+    }
+
+    /// Creates an instance using a registered factory
+    /// @tparam T The type of the instance
+    /// @returns Reference to the IocContainer, for chaining operations
+    /// @throws IocException If object is not contained within the container and there is
+    /// no factory
+    ///     registered to create it
+    template <class T, class... TArgs>
+    IocContainer& create(TArgs&&... args)
+    {
+        return createByName<T>("", std::forward<TArgs>(args)...);
+    }
+
+    /// Creates an instance using a registered factory and assign it the specified name
+    /// @tparam T The type of the instance
+    /// @returns Reference to the IocContainer, for chaining operations
+    /// @throws IocException If object is not contained within the container and there is
+    /// no factory
+    ///     registered to create it
+    template <class T, class... TArgs>
+    IocContainer& createByName(NameKey name, TArgs&&... args)
+    {
+        // Factories may come from a parent, but the instance is always held by this container
+        auto invoker = findFactory<T, TArgs...>(name);
+        return bindInstance(name, invoker->createShared(std::forward<TArgs>(args)...));
+    }
+
+    /// Creates an instance using a registered factory. Unlike create, failures are returned
+    /// rather than raised, so this is suitable without exceptions
+    /// @tparam T The type of the instance
+    /// @param[in] args The arguments to create the instance with
+    /// @returns ErrorCode::None if the instance was created; ErrorCode::NoFactory,
+    /// ErrorCode::UnknownSignature or ErrorCode::InvalidArgument otherwise
+    template <class T, class... TArgs>
+    ErrorCode tryCreate [[nodiscard]] (TArgs&&... args)
+    {
+        return tryCreateByName<T>(NameKey(), std::forward<TArgs>(args)...);
+    }
+
+    /// Creates an instance using a registered factory and assign it the specified name.
+    /// Unlike createByName, failures are returned rather than raised
+    /// @tparam T The type of the instance
+    /// @param[in] name The name of the instance, which is also used to select the factory
+    /// @param[in] args The arguments to create the instance with
+    /// @returns ErrorCode::None if the instance was created; ErrorCode::NoFactory or
+    /// ErrorCode::UnknownSignature if there is no factory for the arguments, or
+    /// ErrorCode::InvalidArgument if an argument can't be passed as its parameter, such as
+    /// an lvalue to an rvalue reference
+    template <class T, class... TArgs>
+    ErrorCode tryCreateByName [[nodiscard]] (NameKey name, TArgs&&... args)
+    {
+        auto instance = tryCreateByNameWithoutStoringShared<T>(name, std::forward<TArgs>(args)...);
+
+        if (!instance)
+        {
+            return instance.error();
+        }
+
+        bindInstance(name, std::move(*instance));
+        return ErrorCode::None;
+    }
+
+    /// Creates an instance using a registered factory, without storing it. Unlike
+    /// createWithoutStoring, failures are returned rather than raised
+    /// @tparam T The type of the instance
+    /// @param[in] args The arguments to create the instance with
+    /// @returns The instance, or the error of tryCreateByNameWithoutStoring
+    template <class T, class... TArgs>
+    Result<std::unique_ptr<T>> tryCreateWithoutStoring [[nodiscard]] (TArgs&&... args)
+    {
+        return tryCreateByNameWithoutStoring<T>(NameKey(), std::forward<TArgs>(args)...);
+    }
+
+    /// Creates an instance using the registered factory of the specified name, without
+    /// storing it. Unlike createByNameWithoutStoring, failures are returned rather than
+    /// raised
+    /// @tparam T The type of the instance
+    /// @param[in] name The name of the factory
+    /// @param[in] args The arguments to create the instance with
+    /// @returns The instance; ErrorCode::NoFactory or ErrorCode::UnknownSignature if there
+    /// is no factory for the arguments, ErrorCode::InvalidArgument if an argument can't be
+    /// passed as its parameter, or ErrorCode::SharedOnlyFactory if the factory is shared
+    template <class T, class... TArgs>
+    Result<std::unique_ptr<T>> tryCreateByNameWithoutStoring
+        [[nodiscard]] (NameKey name, TArgs&&... args)
+    {
+        auto invoker = lookupFactory<T, TArgs...>(name);
+
+        if (!invoker)
+        {
+            return invoker.error();
+        }
+
+        if (!(*invoker)->unique)
+        {
+            return ErrorCode::SharedOnlyFactory;
+        }
+
+        if (!(*invoker)->canCreate(std::forward<TArgs>(args)...))
+        {
+            return ErrorCode::InvalidArgument;
+        }
+
+        return (*invoker)->unique(
+            forwarded_arg<std::decay_t<TArgs>>(std::forward<TArgs>(args))...);
+    }
+
+    /// Creates a shared instance using a registered factory, without storing it. Unlike
+    /// createWithoutStoringShared, failures are returned rather than raised
+    /// @tparam T The type of the instance
+    /// @param[in] args The arguments to create the instance with
+    /// @returns The instance, or the error of tryCreateByNameWithoutStoringShared
+    template <class T, class... TArgs>
+    Result<std::shared_ptr<T>> tryCreateWithoutStoringShared [[nodiscard]] (TArgs&&... args)
+    {
+        return tryCreateByNameWithoutStoringShared<T>(NameKey(), std::forward<TArgs>(args)...);
+    }
+
+    /// Creates a shared instance using the registered factory of the specified name,
+    /// without storing it. Unlike createByNameWithoutStoringShared, failures are returned
+    /// rather than raised
+    /// @tparam T The type of the instance
+    /// @param[in] name The name of the factory
+    /// @param[in] args The arguments to create the instance with
+    /// @returns The instance; ErrorCode::NoFactory or ErrorCode::UnknownSignature if there
+    /// is no factory for the arguments, or ErrorCode::InvalidArgument if an argument can't
+    /// be passed as its parameter
+    template <class T, class... TArgs>
+    Result<std::shared_ptr<T>> tryCreateByNameWithoutStoringShared
+        [[nodiscard]] (NameKey name, TArgs&&... args)
+    {
+        auto invoker = lookupFactory<T, TArgs...>(name);
+
+        if (!invoker)
+        {
+            return invoker.error();
+        }
+
+        if (!(*invoker)->canCreate(std::forward<TArgs>(args)...))
+        {
+            return ErrorCode::InvalidArgument;
+        }
+
+        return (*invoker)->createShared(std::forward<TArgs>(args)...);
+    }
+
+    /// Creates a group of instances using a registered factory, which is held as an
+    /// InstanceGroup<T>. If the factory was registered with registerDefaultFactory, the
+    /// instances are constructed in a single contiguous allocation, otherwise the factory is
+    /// invoked once per instance. The arguments are passed to every instance as lvalues
+    /// @tparam T The type of the instances
+    /// @param[in] count The number of instances to create
+    /// @param[in] args The arguments to create each of the instances with
+    /// @returns Reference to the IocContainer, for chaining operations
+    /// @throws IocException If there is no factory registered to create the instances
+    template <class T, class... TArgs>
+    IocContainer& createMany(std::size_t count, TArgs&&... args)
+    {
+        return createManyByName<T>("", count, args...);
+    }
+
+    /// Creates a group of instances using a registered factory, which is held as an
+    /// InstanceGroup<T> with the specified name. If the factory was registered with
+    /// registerDefaultFactory, the instances are constructed in a single contiguous
+    /// allocation, otherwise the factory is invoked once per instance. The arguments are
+    /// passed to every instance as lvalues
+    /// @tparam T The type of the instances
+    /// @param[in] name The name of the group, which is also used to select the factory
+    /// @param[in] count The number of instances to create
+    /// @param[in] args The arguments to create each of the instances with
+    /// @returns Reference to the IocContainer, for chaining operations
+    /// @throws IocException If there is no factory registered to create the instances
+    template <class T, class... TArgs>
+    IocContainer& createManyByName(NameKey name, std::size_t count, TArgs&&... args)
+    {
+        auto invoker = findFactory<T, TArgs...>(name);
+        return bindInstance(name, invoker->createMany(count, args...));
+    }
+
+    /// Checks whether the container holds an instance of that particular type
+    /// @tparam T The type of the instance
+    /// @returns \c true if contains an instance of that type; \c false otherwise
+    template <class T>
+    bool contains [[nodiscard]] () const
+    {
+        return contains<T>("");
+    }
+
+    /// Checks whether the container holds an instance of that particular type and tag
+    /// @tparam T The type of the instance
+    /// @tparam Tag The tag of the instance
+    /// @returns \c true if contains an instance of that type and tag; \c false otherwise
+    template <class T, class Tag, std::enable_if_t<is_tag_v<T, Tag>>* = nullptr>
+    bool contains [[nodiscard]] () const
+    {
+        Lock lock(mutex_);
+
+        return findInstance(getType<T, Tag>(), NameKey()) != nullptr;
+    }
+
+    /// Checks whether the container holds an instance of that particular type under the
+    /// given index
+    /// @tparam T The type of the instance
+    /// @param[in] index The index of the instance
+    /// @returns \c true if contains an instance of that type; \c false otherwise
+    template <class T>
+    bool contains [[nodiscard]] (std::size_t index) const
+    {
+        Lock lock(mutex_);
+
+        return findIndexed(getType<T>(), index) != nullptr;
+    }
+
+    /// Checks whether the container holds an instance or factory of that particular type
+    /// and particular name
+    /// @tparam T The type of the instance
+    /// @param[in] name The name of the instance
+    /// @returns \c true if contains an instance of that type; \c false otherwise
+    template <class T>
+    bool contains [[nodiscard]] (NameKey name) const
+    {
+        Lock lock(mutex_);
+
+        const auto typeName = getType<T>();
+
+        if (findInstance(typeName, name) != nullptr)
+        {
+            return true;
+        }
+
+        return registeredFactories_.count(typeName) > 0;
+    }
+
+    /// Returns a copy of the object from within the IOC container. This should only be
+    /// used
+    ///     if the object is copy-constructible
+    /// @tparam T The type of the instance
+    /// @returns The instance of the object from within the IOC container
+    /// @throws IocException If object is not contained within the container and there is
+    /// no factory
+    ///     registered to create it
+    template <class T>
+    T get [[nodiscard]] () const
+    {
+        return get<T>("");
+    }
+
+    /// Returns a pointer to the object from within the IOC container. You should NOT
+    /// explicitly
+    //      delete the pointer if the object was created with any ownership semantics
+    /// @tparam T The type of the instance
+    /// @returns The instance of the object from within the IOC container
+    /// @throws IocException If object is not contained within the container and there is
+    /// no factory
+    ///     registered to create it
+    template <class T>
+    T* getPtr [[nodiscard]] () const
+    {
+        return getPtr<T>("");
+    }
+
+    /// Returns a reference to the object from within the IOC container. This is ideal if
+    /// you inserted
+    ///     an instance via a ref/cref semantic or a unique_ptr semantic
+    /// @tparam T The type of the instance
+    /// @returns The instance of the object from within the IOC container
+    /// @throws IocException If object is not contained within the container and there is
+    /// no factory
+    ///     registered to create it
+    template <class T>
+    T& getRef [[nodiscard]] () const
+    {
+        return getRef<T>("");
+    }
+
+    /// Returns a shared_ptr to the object from within the IOC container. This is ideal if
+    /// you inserted
+    ///     the object via the shared_ptr<> mechanism, because you intend to share
+    ///     ownership
+    /// @tparam T The type of the instance
+    /// @returns The instance of the object from within the IOC container
+    /// @throws IocException If object is not contained within the container and there is
+    /// no factory
+    ///     registered to create it
+    template <class T>
+    std::shared_ptr<T> getShared [[nodiscard]] () const
+    {
+        return getShared<T>("");
+    }
+
+    /// Returns a copy of the object from within the IOC container. This should only be
+    /// used
+    ///     if the object is copy-constructible
+    /// @tparam T The type of the instance
+    /// @param name The name of the instance to retrieve
+    /// @returns The instance of the object from within the IOC container
+    /// @throws IocException If object is not contained within the container and there is
+    /// no factory
+    ///     registered to create it
+    template <class T>
+    T get [[nodiscard]] (NameKey name) const
+    {
+        return getInternal<T>(name, &copyOf<T>);
+    }
+
+    /// Returns a pointer to the object from within the IOC container. You should NOT
+    /// explicitly
+    //      delete the pointer if the object was created with any ownership semantics
+    /// @tparam T The type of the instance
+    /// @param name The name of the instance to retrieve
+    /// @returns The instance of the object from within the IOC container
+    /// @throws IocException If object is not contained within the container and there is
+    /// no factory
+    ///     registered to create it
+    template <class T>
+    T* getPtr [[nodiscard]] (NameKey name) const
+    {
+        return getInternal<T>(name, &pointerTo<T>);
+    }
+
+    /// Returns a reference to the object from within the IOC container. This is ideal if
+    /// you inserted
+    ///     an instance via a ref/cref semantic or a unique_ptr semantic
+    /// @tparam T The type of the instance
+    /// @param name The name of the instance to retrieve
+    /// @returns The instance of the object from within the IOC container
+    /// @throws IocException If object is not contained within the container and there is
+    /// no factory
+    ///     registered to create it
+    template <class T>
+    T& getRef [[nodiscard]] (NameKey name) const
+    {
+        return *getInternal<T>(name, &pointerTo<T>);
+    }
+
+    /// Returns a shared_ptr to the object from within the IOC container. This is ideal if
+    /// you inserted
+    ///     the object via the shared_ptr<> mechanism, because you intend to share
+    ///     ownership
+    /// @tparam T The type of the instance
+    /// @param name The name of the instance to retrieve
+    /// @returns The instance of the object from within the IOC container
+    /// @throws IocException If object is not contained within the container and there is
+    /// no factory
+    ///     registered to create it
+    template <class T>
+    std::shared_ptr<T> getShared [[nodiscard]] (NameKey name) const
+    {
+        return getInternal<T>(name, &sharedPtrTo<T>);
+    }
+
+    /// Borrows an instance, without holding a reference count on it. Threads which hold on
+    /// to a heavily shared instance don't contend on its reference count, but only on a
+    /// reader count shared with a few other threads. The instance remains valid until the
+    /// borrowed reference is destroyed, since reclaim waits for it. This requires the
+    /// reclamation to be deferred. Small trivially copyable values are stored inline
+    /// rather than on their own, so they can't be borrowed, and are copied with get instead.
+    /// Each call still locks the container to find the instance, and reclaim waits for
+    /// every borrowed reference, so borrowed references should be short-lived. Threads that
+    /// borrow an instance repeatedly should get a Lender for it once with lend instead
+    /// @tparam T The type of the instance
+    /// @param[in] name The name of the instance
+    /// @returns The borrowed instance
+    /// @throws IocException if the reclamation isn't deferred, or the instance isn't held and
+    /// can't be created
+    template <class T>
+    Borrowed<T> borrow [[nodiscard]] (NameKey name = NameKey()) const
+    {
+        using detail::format;
+        using detail::str;
+
+        static_assert(!Holder::isInline<T>, "Values stored inline can't be borrowed");
+
+        auto* epochs = borrowing_.load(std::memory_order_seq_cst);
+
+        if (epochs != nullptr)
+        {
+            auto guard = epochs->enter();
+
+            // If the reclamation became immediate meanwhile, it may not wait for this reader
+            if (borrowing_.load(std::memory_order_seq_cst) == epochs)
+            {
+                return Borrowed<T>(getPtr<T>(name), std::move(guard));
+            }
+        }
+
+        static const format fmt("Instances can only be borrowed while reclamation is deferred. "
+                                "\n\tExpected Holder Type:  %1%\n\tName                : %2%");
+        CPPINVERT_RAISE(ErrorCode::InvalidArgument,
+                        str(format(fmt) % getType<T>().name() % name.str()));
+    }
+
+    /// Borrows an instance, without holding a reference count on it, see borrow. Unlike
+    /// borrow, failures are returned rather than raised
+    /// @tparam T The type of the instance
+    /// @param[in] name The name of the instance
+    /// @returns The borrowed instance, or ErrorCode::InvalidArgument if the reclamation
+    /// isn't deferred, or the error of tryGetPtr
+    template <class T>
+    Result<Borrowed<T>> tryBorrow [[nodiscard]] (NameKey name = NameKey()) const
+    {
+        static_assert(!Holder::isInline<T>, "Values stored inline can't be borrowed");
+
+        auto* epochs = borrowing_.load(std::memory_order_seq_cst);
+
+        if (epochs == nullptr)
+        {
+            return ErrorCode::InvalidArgument;
+        }
+
+        auto guard = epochs->enter();
+
+        // If the reclamation became immediate meanwhile, it may not wait for this reader
+        if (borrowing_.load(std::memory_order_seq_cst) != epochs)
+        {
+            return ErrorCode::InvalidArgument;
+        }
+
+        auto instance = tryGetPtr<T>(name);
+
+        if (!instance)
+        {
+            return instance.error();
+        }
+
+        return Borrowed<T>(*instance, std::move(guard));
+    }
+
+    /// Returns a lender of an instance, which threads can hold on to and borrow the instance
+    /// from without locking the container, or contending on its reference count. The
+    /// instance is resolved once, and the lender keeps it alive, so it keeps lending the same
+    /// instance after the binding is erased or replaced. Borrowing from a lender doesn't
+    /// require the reclamation to be deferred, and never holds up reclaim. Small trivially
+    /// copyable values are stored inline, so they can't be lent, and are copied with get
+    /// @tparam T The type of the instance
+    /// @param[in] name The name of the instance
+    /// @returns The lender of the instance
+    /// @throws IocException if the instance isn't held and can't be created
+    template <class T>
+    std::shared_ptr<Lender<T>> lend [[nodiscard]] (NameKey name = NameKey()) const
+    {
+        static_assert(!Holder::isInline<T>, "Values stored inline can't be lent");
+
+        return std::make_shared<Lender<T>>(getShared<T>(name));
+    }
+
+    /// Returns a lender of an instance, see lend. Unlike lend, failures are returned rather
+    /// than raised
+    /// @tparam T The type of the instance
+    /// @param[in] name The name of the instance
+    /// @returns The lender, or the error of tryGetShared
+    template <class T>
+    Result<std::shared_ptr<Lender<T>>> tryLend [[nodiscard]] (NameKey name = NameKey()) const
+    {
+        static_assert(!Holder::isInline<T>, "Values stored inline can't be lent");
+
+        auto instance = tryGetShared<T>(name);
+
+        if (!instance)
+        {
+            return instance.error();
+        }
+
+        return std::make_shared<Lender<T>>(std::move(instance).value());
+    }
+
+    /// Returns a copy of the tagged object from within the IOC container. This should only
+    /// be used if the object is copy-constructible
+    /// @tparam T The type of the instance
+    /// @tparam Tag The tag of the instance
+    /// @returns The instance of the object from within the IOC container
+    /// @throws IocException If no object of that type is bound with that tag
+    template <class T, class Tag, std::enable_if_t<is_tag_v<T, Tag>>* = nullptr>
+    T get [[nodiscard]] () const
+    {
+        return getTaggedInternal<T, Tag>(&copyOf<T>);
+    }
+
+    /// Returns a pointer to the tagged object from within the IOC container
+    /// @tparam T The type of the instance
+    /// @tparam Tag The tag of the instance
+    /// @returns The instance of the object from within the IOC container
+    /// @throws IocException If no object of that type is bound with that tag
+    template <class T, class Tag, std::enable_if_t<is_tag_v<T, Tag>>* = nullptr>
+    T* getPtr [[nodiscard]] () const
+    {
+        return getTaggedInternal<T, Tag>(&pointerTo<T>);
+    }
+
+    /// Returns a reference to the tagged object from within the IOC container. Without
+    /// exceptions, tryGetPtr returns the error instead
+    /// @tparam T The type of the instance
+    /// @tparam Tag The tag of the instance
+    /// @returns The instance of the object from within the IOC container
+    /// @throws IocException If no object of that type is bound with that tag
+    template <class T, class Tag, std::enable_if_t<is_tag_v<T, Tag>>* = nullptr>
+    T& getRef [[nodiscard]] () const
+    {
+        return *getTaggedInternal<T, Tag>(&pointerTo<T>);
+    }
+
+    /// Returns a shared_ptr to the tagged object from within the IOC container
+    /// @tparam T The type of the instance
+    /// @tparam Tag The tag of the instance
+    /// @returns The instance of the object from within the IOC container
+    /// @throws IocException If no object of that type is bound with that tag
+    template <class T, class Tag, std::enable_if_t<is_tag_v<T, Tag>>* = nullptr>
+    std::shared_ptr<T> getShared [[nodiscard]] () const
+    {
+        return getTaggedInternal<T, Tag>(&sharedPtrTo<T>);
+    }
+
+    /// Returns a copy of the indexed object from within the IOC container. This should
+    /// only be used if the object is copy-constructible
+    /// @tparam T The type of the instance
+    /// @param index The index of the instance to retrieve
+    /// @returns The instance of the object from within the IOC container
+    /// @throws IocException If no object is bound under that index
+    template <class T>
+    T get [[nodiscard]] (std::size_t index) const
+    {
+        return getIndexedInternal<T>(index, &copyOf<T>);
+    }
+
+    /// Returns a pointer to the indexed object from within the IOC container
+    /// @tparam T The type of the instance
+    /// @param index The index of the instance to retrieve
+    /// @returns The instance of the object from within the IOC container
+    /// @throws IocException If no object is bound under that index
+    template <class T>
+    T* getPtr [[nodiscard]] (std::size_t index) const
+    {
+        return getIndexedInternal<T>(index, &pointerTo<T>);
+    }
+
+    /// Returns a reference to the indexed object from within the IOC container
+    /// @tparam T The type of the instance
+    /// @param index The index of the instance to retrieve
+    /// @returns The instance of the object from within the IOC container
+    /// @throws IocException If no object is bound under that index
+    template <class T>
+    T& getRef [[nodiscard]] (std::size_t index) const
+    {
+        return *getIndexedInternal<T>(index, &pointerTo<T>);
+    }
+
+    /// Returns a shared_ptr to the indexed object from within the IOC container
+    /// @tparam T The type of the instance
+    /// @param index The index of the instance to retrieve
+    /// @returns The instance of the object from within the IOC container
+    /// @throws IocException If no object is bound under that index
+    template <class T>
+    std::shared_ptr<T> getShared [[nodiscard]] (std::size_t index) const
+    {
+        return getIndexedInternal<T>(index, &sharedPtrTo<T>);
+    }
+
+    /// Returns a pointer to the object from within the IOC container. Unlike getPtr,
+    /// failures are returned rather than raised, so this is suitable without exceptions
+    /// @tparam T The type of the instance
+    /// @returns The instance, or ErrorCode::NotFound if it isn't held and can't be created
+    template <class T>
+    Result<T*> tryGetPtr [[nodiscard]] () const
+    {
+        return tryGetPtr<T>(NameKey());
+    }
+
+    /// Returns a pointer to the object from within the IOC container. Unlike getPtr,
+    /// failures are returned rather than raised, so this is suitable without exceptions
+    /// @tparam T The type of the instance
+    /// @param name The name of the instance to retrieve
+    /// @returns The instance, or ErrorCode::NotFound if it isn't held and there is no
+    /// factory to create it, or the error of the factory lookup if there is
+    template <class T>
+    Result<T*> tryGetPtr [[nodiscard]] (NameKey name) const
+    {
+        Lock lock(mutex_);
+        auto holder = lookup<T>(name);
+
+        if (!holder)
+        {
+            return holder.error();
+        }
+
+        return read(**holder, lock, &pointerTo<T>);
+    }
+
+    /// Returns a pointer to the tagged object from within the IOC container, or
+    /// ErrorCode::NotFound
+    /// @tparam T The type of the instance
+    /// @tparam Tag The tag of the instance
+    template <class T, class Tag, std::enable_if_t<is_tag_v<T, Tag>>* = nullptr>
+    Result<T*> tryGetPtr [[nodiscard]] () const
+    {
+        Lock lock(mutex_);
+        auto holder = lookupTagged<T, Tag>();
+
+        if (!holder)
+        {
+            return holder.error();
+        }
+
+        return read(**holder, lock, &pointerTo<T>);
+    }
+
+    /// Returns a pointer to the indexed object from within the IOC container, or
+    /// ErrorCode::NotFound
+    /// @tparam T The type of the instance
+    /// @param index The index of the instance to retrieve
+    template <class T>
+    Result<T*> tryGetPtr [[nodiscard]] (std::size_t index) const
+    {
+        Lock lock(mutex_);
+        auto holder = lookupIndexed<T>(index);
+
+        if (!holder)
+        {
+            return holder.error();
+        }
+
+        return read(**holder, lock, &pointerTo<T>);
+    }
+
+    /// Returns a shared_ptr to the object from within the IOC container. Unlike
+    /// getShared, failures are returned rather than raised
+    /// @tparam T The type of the instance
+    /// @returns The instance, or ErrorCode::NotFound if it isn't held and can't be created
+    template <class T>
+    Result<std::shared_ptr<T>> tryGetShared [[nodiscard]] () const
+    {
+        return tryGetShared<T>(NameKey());
+    }
+
+    /// Returns a shared_ptr to the object from within the IOC container. Unlike
+    /// getShared, failures are returned rather than raised
+    /// @tparam T The type of the instance
+    /// @param name The name of the instance to retrieve
+    /// @returns The instance, or ErrorCode::NotFound if it isn't held and there is no
+    /// factory to create it, or the error of the factory lookup if there is
+    template <class T>
+    Result<std::shared_ptr<T>> tryGetShared [[nodiscard]] (NameKey name) const
+    {
+        Lock lock(mutex_);
+        auto holder = lookup<T>(name);
+
+        if (!holder)
+        {
+            return holder.error();
+        }
+
+        return read(**holder, lock, &sharedPtrTo<T>);
+    }
+
+    /// Returns a shared_ptr to the tagged object from within the IOC container, or
+    /// ErrorCode::NotFound
+    /// @tparam T The type of the instance
+    /// @tparam Tag The tag of the instance
+    template <class T, class Tag, std::enable_if_t<is_tag_v<T, Tag>>* = nullptr>
+    Result<std::shared_ptr<T>> tryGetShared [[nodiscard]] () const
+    {
+        Lock lock(mutex_);
+        auto holder = lookupTagged<T, Tag>();
+
+        if (!holder)
+        {
+            return holder.error();
+        }
+
+        return read(**holder, lock, &sharedPtrTo<T>);
+    }
+
+    /// Returns a shared_ptr to the indexed object from within the IOC container, or
+    /// ErrorCode::NotFound
+    /// @tparam T The type of the instance
+    /// @param index The index of the instance to retrieve
+    template <class T>
+    Result<std::shared_ptr<T>> tryGetShared [[nodiscard]] (std::size_t index) const
+    {
+        Lock lock(mutex_);
+        auto holder = lookupIndexed<T>(index);
+
+        if (!holder)
+        {
+            return holder.error();
+        }
+
+        return read(**holder, lock, &sharedPtrTo<T>);
+    }
+
+    // Retrieve a static constant instance of this object for cases where we are calling
+    // through to an IOC container, but have nothing to put in it. This will ensure the
+    // correct object lifetime
+    static const IocContainer& emptyContainer()
+    {
+        static const IocContainer empty;
 
-        return registerFactory<T>(factory);
+        return empty;
     }
 
-    /// Registers a factory function for a given type
-    /// @tparam T The type of the instance that will be created
-    /// @param[in] factory The factory function to create the given type
-    /// @returns Reference to the IocContainer, for chaining operations
-    template <class T, class TFactory>
-    IocContainer& registerFactory(TFactory factory)
+private:
+    using Holder = InstanceHolder;
+
+    /// Map from names to values. Entries are indexed by the hash of their NameKey, so a
+    /// lookup never builds or hashes a std::string, and names are only compared when the
+    /// hashes match
+    /// @tparam TValue The type of the values
+    template <class TValue>
+    class NameMap
     {
-        Lock lock(mutex_);
+    public:
+        struct Entry
+        {
+            std::string name;
+            TValue value;
+        };
 
-        auto typeName = getType<T>();
-        registeredFactories_.insert_or_assign(typeName, factory);
-        return *this;
-    }
+        // The hash of the name is already computed by the NameKey
+        struct IdentityHash
+        {
+            std::size_t operator()(std::size_t hash) const noexcept
+            {
+                return hash;
+            }
+        };
 
-    /// Registers an instance for a given type. This version performs a copy of the
-    /// object, using the copy
-    ///     constructor and will manage lifetime via the Holder (shared_ptr)
-    /// @tparam T The type of the instance
-    /// @param[in] instance The instance to be held within the container
-    /// @returns Reference to the IocContainer, for chaining operations
-    template <class T>
-    IocContainer& bindValue(value_wrapper<T> instance)
+        using Entries = std::unordered_multimap<std::size_t, Entry, IdentityHash>;
+        using iterator = typename Entries::iterator;
+        using const_iterator = typename Entries::const_iterator;
+
+        iterator find(NameKey key)
+        {
+            auto [first, last] = entries_.equal_range(key.hash());
+
+            for (; first != last; ++first)
+            {
+                if (first->second.name == key.str())
+                {
+                    return first;
+                }
+            }
+
+            return entries_.end();
+        }
+
+        const_iterator find(NameKey key) const
+        {
+            return const_cast<NameMap*>(this)->find(key);
+        }
+
+        std::pair<iterator, bool> try_emplace(NameKey key)
+        {
+            auto iter = find(key);
+
+            if (iter != entries_.end())
+            {
+                return {iter, false};
+            }
+
+            return {entries_.emplace(key.hash(), Entry{std::string(key.str()), TValue()}), true};
+        }
+
+        void insert_or_assign(NameKey key, TValue value)
+        {
+            try_emplace(key).first->second.value = std::move(value);
+        }
+
+        TValue& operator[](NameKey key)
+        {
+            return try_emplace(key).first->second.value;
+        }
+
+        void erase(iterator iter)
+        {
+            entries_.erase(iter);
+        }
+
+        std::size_t size() const noexcept
+        {
+            return entries_.size();
+        }
+
+        iterator begin() noexcept
+        {
+            return entries_.begin();
+        }
+
+        iterator end() noexcept
+        {
+            return entries_.end();
+        }
+
+        const_iterator begin() const noexcept
+        {
+            return entries_.begin();
+        }
+
+        const_iterator end() const noexcept
+        {
+            return entries_.end();
+        }
+
+    private:
+        Entries entries_;
+    };
+
+    /// Map from the dense indices of type keys to the unnamed instances of those types.
+    /// A lookup is one bounds check and one load from an array of pointers, which is indexed
+    /// directly by the type. The holders themselves are appended to a deque as their types
+    /// are first bound, so only the pointer array grows with the types the process has used,
+    /// and holders stay in place as it grows. The holder of an erased instance is kept empty
+    /// for reuse
+    class UnnamedMap
     {
-        return bindValue<T>("", std::move(instance));
-    }
+    public:
+        Holder* find(std::size_t index) noexcept
+        {
+            return index < slots_.size() ? slots_[index] : nullptr;
+        }
+
+        const Holder* find(std::size_t index) const noexcept
+        {
+            return index < slots_.size() ? slots_[index] : nullptr;
+        }
+
+        Holder& operator[](std::size_t index)
+        {
+            if (index >= slots_.size())
+            {
+                slots_.resize(index + 1, nullptr);
+            }
+
+            auto& slot = slots_[index];
+
+            if (!slot)
+            {
+                slot = &holders_.emplace_back();
+            }
+
+            return *slot;
+        }
+
+        void clear() noexcept
+        {
+            slots_.clear();
+            holders_.clear();
+        }
+
+        std::deque<Holder>::const_iterator begin() const noexcept
+        {
+            return holders_.begin();
+        }
+
+        std::deque<Holder>::const_iterator end() const noexcept
+        {
+            return holders_.end();
+        }
+
+    private:
+        // The holder of each type index, or null if the type was never bound
+        std::vector<Holder*> slots_;
+
+        // The holders, in the order their types were first bound
+        std::deque<Holder> holders_;
+    };
+
+    // Factories of a type and name, indexed by the type key of their FactoryInvoker, which
+    // identifies the signature
+    using FactoryOverloads = std::unordered_map<TypeKey, Holder, TypeKey::Hash>;
+    using NamedFactories = NameMap<FactoryOverloads>;
+    using RegisteredFactories = std::unordered_map<TypeKey, NamedFactories, TypeKey::Hash>;
 
-    /// Registers an instance for a given type. This version performs a copy of the
-    /// object, using the copy
-    ///     constructor and will manage lifetime via the Holder (shared_ptr)
-    /// @tparam T The type of the instance
-    /// @param[in] instance The instance to be held within the container
-    /// @returns Reference to the IocContainer, for chaining operations
     template <class T>
-    std::enable_if_t<!is_wrapped_v<T>, IocContainer&> bindValue(T instance)
+    using HolderPtr = std::shared_ptr<T>;
+
+    using InnerRegisteredInstanceMap = NameMap<Holder>;
+    using RegisteredInstances =
+        std::unordered_map<TypeKey, InnerRegisteredInstanceMap, TypeKey::Hash>;
+
+    // Indexed instances of a type, where the position is the index. Gaps hold empty holders
+    using IndexedInstances = std::unordered_map<TypeKey, std::vector<Holder>, TypeKey::Hash>;
+
+    using Mutex = std::recursive_mutex;
+    using Lock = std::unique_lock<Mutex>;
+
+    /// Interface to the cache of a memoizing factory, independent of its signature
+    class FactoryCache
     {
-        return bindValue<T>("", std::move(instance));
-    }
+    public:
+        virtual ~FactoryCache()
+        {
+        }
 
-    /// Registers an instance for a given type. This version refers to the object and will
-    /// not manage lifetime
-    ///     as the shared_ptr will have a null deleter. To call this, use:
-    ///     bindInstance(std::ref(instance)) or bindInstance(std:::cref(instance))
+        virtual MemoizationStats stats() const = 0;
+    };
+
+    /// Type-erased factory for a given signature. The registered factory is wrapped, so
+    /// that it can be invoked with forwarded arguments, regardless of whether it takes its
+    /// parameters by value or by reference
+    /// @tparam T The type of the instance that will be created
+    /// @tparam TArgs The parameters of the registered factory
+    template <class T, class... TArgs>
+    struct FactoryInvoker
+    {
+        template <class... TParams>
+        using UniqueFunction = std::function<std::unique_ptr<T>(forwarded_arg<TParams>...)>;
+
+        template <class... TParams>
+        using SharedFunction = std::function<std::shared_ptr<T>(forwarded_arg<TParams>...)>;
+
+        using Signature = FactoryInvoker<T, std::decay_t<TArgs>...>;
+
+        /// Wraps the factory into an invoker for the decayed signature
+        template <class TResult, class TFactory>
+        static Signature make(TFactory factory)
+        {
+            Signature invoker;
+
+            auto call = [factory = std::move(factory)](
+                            forwarded_arg<std::decay_t<TArgs>>... args) mutable {
+                return factory(args.template get<TArgs>()...);
+            };
+
+            invoker.accepts = [](const forwarded_arg<std::decay_t<TArgs>>&... args) {
+                return (args.template accepts<TArgs>() && ... && true);
+            };
+
+            if constexpr (std::is_constructible_v<std::unique_ptr<T>, TResult>)
+            {
+                invoker.unique = [call = std::move(call)](auto... args) mutable {
+                    return std::unique_ptr<T>(call(args...));
+                };
+            }
+            else
+            {
+                invoker.shared = [call = std::move(call)](auto... args) mutable {
+                    return std::shared_ptr<T>(call(args...));
+                };
+            }
+
+            return invoker;
+        }
+
+        /// Creates an instance, regardless of which kind of factory was registered
+        template <class... TForwarded>
+        std::shared_ptr<T> createShared(TForwarded&&... args) const
+        {
+            if (unique)
+            {
+                return unique(forwarded_arg<TArgs>(std::forward<TForwarded>(args))...);
+            }
+
+            return shared(forwarded_arg<TArgs>(std::forward<TForwarded>(args))...);
+        }
+
+        /// Checks whether the arguments can be passed as the parameters of the factory, which
+        /// the create methods otherwise raise ErrorCode::InvalidArgument for
+        template <class... TForwarded>
+        bool canCreate [[nodiscard]] (TForwarded&&... args) const noexcept
+        {
+            return accepts(forwarded_arg<TArgs>(std::forward<TForwarded>(args))...);
+        }
+
+        /// Creates a group of instances, each of them from the same arguments
+        template <class... TForwarded>
+        std::shared_ptr<InstanceGroup<T>> createMany(std::size_t count,
+                                                     TForwarded&... args) const
+        {
+            if (bulk)
+            {
+                return bulk(count, forwarded_arg<TArgs>(args)...);
+            }
+
+            std::vector<std::shared_ptr<T>> instances;
+            instances.reserve(count);
+
+            for (std::size_t index = 0; index < count; ++index)
+            {
+                instances.push_back(createShared(args...));
+            }
+
+            return InstanceGroup<T>::make(std::move(instances));
+        }
+
+        UniqueFunction<TArgs...> unique;
+        SharedFunction<TArgs...> shared;
+
+        // Checks the categories of the arguments against the parameters of the factory
+        bool (*accepts)(const forwarded_arg<TArgs>&...) = nullptr;
+
+        // Creates a group of instances in a single allocation, if the concrete type is known
+        std::function<std::shared_ptr<InstanceGroup<T>>(std::size_t, forwarded_arg<TArgs>...)>
+            bulk;
+
+        // The cache of the factory, if it is memoizing
+        std::shared_ptr<const FactoryCache> cache;
+    };
+
+    /// Bounded cache of the instances created by a memoizing factory, indexed by the hash
+    /// of the arguments they were created with. Lookups compare the arguments in place, so
+    /// they are only copied when a new instance is cached
+    /// @tparam T The type of the instances
+    /// @tparam TArgs The arguments the instances are created from
+    template <class T, class... TArgs>
+    class MemoizedCache : public FactoryCache
+    {
+    public:
+        using Function = std::function<std::shared_ptr<T>(const TArgs&...)>;
+
+        MemoizedCache(Function factory, std::size_t capacity, EvictionPolicy policy)
+            : factory_(std::move(factory))
+            , capacity_(capacity)
+            , policy_(policy)
+        {
+        }
+
+        /// Returns the cached instance for the arguments, creating it on a miss
+        std::shared_ptr<T> get(const TArgs&... args)
+        {
+            const auto hash = hashArgs(args...);
+
+            {
+                std::lock_guard<std::mutex> lock(mutex_);
+
+                if (auto instance = lookup(hash, args...))
+                {
+                    ++stats_.hits;
+                    return instance;
+                }
+
+                ++stats_.misses;
+            }
+
+            // Create outside of the lock, so a slow factory doesn't hold up other lookups
+            auto instance = factory_(args...);
+
+            std::lock_guard<std::mutex> lock(mutex_);
+
+            // Another thread may have cached an instance in the meantime, which wins
+            if (auto cached = lookup(hash, args...))
+            {
+                return cached;
+            }
+
+            entries_.push_front(Entry{hash, std::tuple<TArgs...>(args...), instance});
+            index_.emplace(hash, entries_.begin());
+
+            while (entries_.size() > capacity_)
+            {
+                evict();
+            }
+
+            return instance;
+        }
+
+        MemoizationStats stats() const override
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+
+            auto stats = stats_;
+            stats.size = entries_.size();
+            return stats;
+        }
+
+    private:
+        struct Entry
+        {
+            std::size_t hash;
+            std::tuple<TArgs...> args;
+            std::shared_ptr<T> instance;
+        };
+
+        using Entries = std::list<Entry>;
+
+        static std::size_t hashArgs(const TArgs&... args)
+        {
+            std::size_t seed = 0;
+
+            ((seed ^= std::hash<TArgs>()(args) + 0x9e3779b9 + (seed << 6) + (seed >> 2)), ...);
+
+            return seed;
+        }
+
+        // Finds the cached instance, refreshing it for the least recently used policy
+        std::shared_ptr<T> lookup(std::size_t hash, const TArgs&... args)
+        {
+            auto range = index_.equal_range(hash);
+
+            for (auto iter = range.first; iter != range.second; ++iter)
+            {
+                auto entry = iter->second;
+
+                if (entry->args == std::tie(args...))
+                {
+                    if (policy_ == EvictionPolicy::LeastRecentlyUsed)
+                    {
+                        entries_.splice(entries_.begin(), entries_, entry);
+                    }
+
+                    return entry->instance;
+                }
+            }
+
+            return nullptr;
+        }
+
+        // Discards the entry at the back, which is the oldest or least recently used
+        void evict()
+        {
+            auto entry = std::prev(entries_.end());
+            auto range = index_.equal_range(entry->hash);
+
+            for (auto iter = range.first; iter != range.second; ++iter)
+            {
+                if (iter->second == entry)
+                {
+                    index_.erase(iter);
+                    break;
+                }
+            }
+
+            entries_.erase(entry);
+            ++stats_.evictions;
+        }
+
+        Function factory_;
+        std::size_t capacity_;
+        EvictionPolicy policy_;
+
+        // Entries ordered from the most to the least recently used or inserted
+        Entries entries_;
+        std::unordered_multimap<std::size_t, typename Entries::iterator> index_;
+        MemoizationStats stats_;
+        mutable std::mutex mutex_;
+    };
+
+    // Releases a newly reserved slot again, unless constructing the instance succeeded
+    struct SlotReservation
+    {
+        ~SlotReservation()
+        {
+            if (release)
+            {
+                container.eraseInstanceInternal(typeKey, name);
+            }
+        }
+
+        IocContainer& container;
+        TypeKey typeKey;
+        NameKey name;
+        bool release;
+    };
+
+    /// Registers an instance for a given type. This version will take in a
+    /// holder pointer, which will become a shared_ptr if it isn't already and share
+    /// lifetime with any other shared_ptrs that reference it
     /// @tparam T The type of the instance
+    /// @tparam T2 The wrapper around the instance
+    /// @param[in] name The name of the instance
     /// @param[in] instance The instance to be held within the container
-    /// @returns Reference to the IocContainer, for chaining operations
+    /// @returnsReference to the IocContainer, for chaining operations
     template <class T>
-    IocContainer& bindInstance(std::reference_wrapper<T> instance)
+    IocContainer& bindInstanceInternal(NameKey name, HolderPtr<T> instance)
     {
-        return bindInstance<T>("", instance);
+        return bindInstanceInternal(getType<T>(), name, Holder(std::move(instance)));
     }
 
-#if 0
-    /// Registers an instance for a given type. This version performs a copy of the
-    /// object, using the copy
-    ///     constructor and will manage lifetime via the Holder (shared_ptr)
-    /// @tparam T The type of the instance
-    /// @param[in] instance The instance to be held within the container
-    /// @returns Reference to the IocContainer, for chaining operations
-    // template <class T, typename std::enable_if_t<!is_wrapped_v<T>, T>* = nullptr>
-    template <class T>
-    IocContainer& bindInstance(T instance)
+    // Returns the NUMA topology, which is the topology of the machine unless one was set
+    std::shared_ptr<const NumaTopology> numaTopology() const
     {
-        return bindInstance<T>("", std::move(instance));
+        Lock lock(mutex_);
+
+        return numaTopology_ ? numaTopology_ : NumaTopology::system();
     }
+
+    // Creates an instance on a thread pinned to a node, so its memory is allocated there
+    template <class TCreate>
+    static auto createOnNode(const NumaTopology& topology, std::size_t node, TCreate& create)
+    {
+        decltype(create()) instance;
+#ifndef CPPINVERT_NO_EXCEPTIONS
+        std::exception_ptr error;
 #endif
 
-    /// Registers an instance for a given type. This version refers to the object and will
-    /// not manage lifetime
-    ///     as the shared_ptr will have a null deleter. To call this, use:
-    ///     bindInstance(std::ref(instance)) or bindInstance(std:::cref(instance))
-    /// @tparam TBase The type of the instance
-    /// @tparam TDerived The type of the instance
-    /// @param[in] instance The instance to be held within the container
-    /// @returns Reference to the IocContainer, for chaining operations
-    template <class TBase,
-              class TDerived,
-              typename std::enable_if_t<!std::is_same_v<TBase, TDerived>, TDerived>* = nullptr>
-    IocContainer& bindInstance(std::reference_wrapper<TDerived> instance)
+        std::thread([&] {
+            topology.pinToNode(node);
+#ifndef CPPINVERT_NO_EXCEPTIONS
+            try
+            {
+                instance = create();
+            }
+            catch (...)
+            {
+                error = std::current_exception();
+            }
+#else
+            instance = create();
+#endif
+        }).join();
+
+#ifndef CPPINVERT_NO_EXCEPTIONS
+        if (error)
+        {
+            std::rethrow_exception(error);
+        }
+#endif
+
+        return instance;
+    }
+
+    // Binds the instances of a lifetime, which resolves the instance for the caller
+    template <class T, class TInstances>
+    IocContainer& bindLifetime(NameKey name,
+                               std::shared_ptr<TInstances> instances,
+                               Holder::Adjust resolve)
     {
-        return bindInstance<TBase, TDerived>("", instance);
+        auto slot = std::make_shared<Holder>(std::move(instances));
+
+        return bindInstanceInternal(
+            getType<T>(), name, Holder::makeLink<T>(std::move(slot), resolve));
     }
 
-    /// Registers an instance for a given type. This version refers to a pointer to be
-    /// held within the container
-    ///     and does not manage lifetime. If you want to manage lifetime, please see the
-    ///     unique_ptr or shared_ptr versions
-    /// @tparam T The type of the instance
-    /// @param[in] instance The instance to be held within the container
-    /// @returns Reference to the IocContainer, for chaining operations
-    template <class T>
-    IocContainer& bindInstance(T* instance)
+    // Returns the instances behind a lifetime binding, if they are of the given kind
+    template <class T, class TInstances>
+    std::shared_ptr<TInstances> getLifetime [[nodiscard]] (NameKey name, const char* kind) const
     {
-        return bindInstance<T>("", instance);
+        using detail::format;
+        using detail::str;
+
+        Lock lock(mutex_);
+        auto instances = lookupLifetime<T, TInstances>(name);
+
+        if (!instances)
+        {
+            static const format fmt("Item not found by type and name with %1%. \n\t"
+                                    "Expected Holder Type:  %2%\n\tName                : %3%");
+            CPPINVERT_RAISE(instances.error(),
+                            str(format(fmt) % kind % getType<T>().name() % name.str()));
+        }
+
+        return std::move(instances).value();
     }
 
-    /// Registers an instance for a given type. This version will take in a unique_ptr,
-    /// take ownership and manage
-    ///     lifetime via a Holder (shared_ptr)
-    /// @tparam T The type of the instance
-    /// @param[in] instance The instance to be held within the container
-    /// @returns Reference to the IocContainer, for chaining operations
-    template <class T>
-    IocContainer& bindInstance(std::unique_ptr<T> instance)
+    // Version of getLifetime which reports failures as an ErrorCode, rather than raising
+    // them. This must be called with the lock held
+    template <class T, class TInstances>
+    Result<std::shared_ptr<TInstances>> lookupLifetime [[nodiscard]] (NameKey name) const
     {
-        return bindInstance<T>("", instance);
+        const Holder* holder = findInstance(getType<T>(), name);
+        const Holder* instances = holder ? holder->linkTarget() : nullptr;
+
+        if (instances == nullptr || instances->type() != getType<TInstances>())
+        {
+            return ErrorCode::NotFound;
+        }
+
+        return instances->template getShared<TInstances>();
     }
 
-    /// Registers an instance for a given type. This version will take in a shared_ptr and
-    /// share lifetime with
-    //      any other shared_ptrs that reference it
-    /// @tparam T The type of the instance
-    /// @param[in] instance The instance to be held within the container
-    /// @returns Reference to the IocContainer, for chaining operations
+    // Resolves the replica for the calling thread, as the instance of a lifetime binding
     template <class T>
-    IocContainer& bindInstance(std::shared_ptr<T> instance)
+    static void* resolveReplica(void* replicas)
     {
-        return bindInstance<T>("", instance);
+        return &static_cast<Replicas<T>*>(replicas)->local();
     }
 
-    /// Registers an instance for a given type. This version performs a copy of the
-    /// object, using the copy
-    ///     constructor and will manage lifetime via the Holder (shared_ptr)
-    /// @tparam T The type of the instance
-    /// @param[in] name The name of the instance
-    /// @param[in] instance The instance to be held within the container
-    /// @returns Reference to the IocContainer, for chaining operations
+    // Resolves the instance of the calling thread, as the instance of a lifetime binding
     template <class T>
-    IocContainer& bindInstance(const std::string& name, std::reference_wrapper<T> instance)
+    static void* resolveThreadLocal(void* instances)
     {
-        return bindInstanceInternal<T>(name, HolderPtr<T>{&instance.get(), nullDeleter_v<T>});
+        return &static_cast<ThreadLocal<T>*>(instances)->local();
     }
 
-#if 0
-    /// Registers an instance for a given type. This version performs a copy of the
-    /// object, using the copy
-    ///     constructor and will manage lifetime via the Holder (shared_ptr)
-    /// @tparam T The type of the instance
-    /// @param[in] name The name of the instance
-    /// @param[in] instance The instance to be held within the container
-    /// @returns Reference to the IocContainer, for chaining operations
-    // template <class T, typename std::enable_if_t<!is_wrapped_v<T>, T>* = nullptr>
-    template <class T>
-    IocContainer& bindInstance(const std::string& name, T instance)
+    // Constructs the instance of a per-core replica within the storage of the replica. It
+    // is moved out of the allocation of the factory, unless the factory returns it by value
+    template <class T, bool byValue, class TFactory>
+    static std::shared_ptr<T> constructReplica(void* storage, TFactory& factory)
     {
-        return bindValue(name, value_wrapper<T>{std::move(instance)});
+        T* instance = nullptr;
+
+        if constexpr (byValue)
+        {
+            instance = new (storage) T(factory());
+        }
+        else
+        {
+            const std::unique_ptr<T> created(factory());
+            instance = new (storage) T(std::move(*created));
+        }
+
+        // The storage is released by the replicas, so only the instance is destroyed here
+        return std::shared_ptr<T>(instance, [](T* replica) { replica->~T(); });
     }
-#endif
 
-    /// Registers an instance for a given type. This version performs a copy of the
-    /// object, using the copy
-    ///     constructor and will manage lifetime via the Holder (shared_ptr)
-    /// @tparam TBase The base type of the instance
-    /// @tparam TDerived The type of the instance
-    /// @param[in] name The name of the instance
-    /// @param[in] instance The instance to be held within the container
-    /// @returns Reference to the IocContainer, for chaining operations
-    template <class TBase,
-              class TDerived,
-              typename std::enable_if_t<!std::is_same_v<TBase, TDerived>, TDerived>* = nullptr>
-    IocContainer& bindInstance(const std::string& name, std::reference_wrapper<TDerived> instance)
+    // Converts each of the ways of passing an instance to bindInstance to a holder pointer,
+    // where only unique_ptr and shared_ptr manage the lifetime of the instance
+    template <class T>
+    static HolderPtr<T> toHolderPtr(std::reference_wrapper<T> instance)
     {
-        return bindInstanceInternal<TBase>(name,
-                                           HolderPtr<TBase>{&instance.get(), nullDeleter_v<TBase>});
+        return HolderPtr<T>{&instance.get(), nullDeleter_v<T>};
     }
 
-    /// Registers an instance for a given type. This version performs a copy of the
-    /// object, using the copy
-    ///     constructor and will manage lifetime via the Holder (shared_ptr)
-    /// @tparam T The type of the instance
-    /// @param[in] name The name of the instance
-    /// @param[in] instance The instance to be held within the container
-    /// @returns Reference to the IocContainer, for chaining operations
     template <class T>
-    IocContainer& bindInstance(const std::string& name, T* instance)
+    static HolderPtr<T> toHolderPtr(T* instance)
     {
-        return bindInstanceInternal<T>(name, HolderPtr<T>(instance, nullDeleter_v<T>));
+        return HolderPtr<T>(instance, nullDeleter_v<T>);
     }
 
-    /// Registers an instance for a given type. This version will take in a unique_ptr,
-    /// take ownership and manage
-    ///     lifetime via a Holder (shared_ptr)
-    /// @tparam T The type of the instance
-    /// @param[in] name The name of the instance
-    /// @param[in] instance The instance to be held within the container
-    /// @returns Reference to the IocContainer, for chaining operations
     template <class T>
-    IocContainer& bindInstance(const std::string& name, std::unique_ptr<T> instance)
+    static HolderPtr<T> toHolderPtr(std::unique_ptr<T> instance)
     {
-        return bindInstanceInternal<T>(name, std::move(instance));
+        return HolderPtr<T>(std::move(instance));
     }
 
-    /// Registers an instance for a given type. This version will take in a shared_ptr and
-    /// share lifetime with any other shared_ptrs that reference it
-    /// @tparam T The type of the instance
-    /// @param[in] name The name of the instance
-    /// @param[in] instance The instance to be held within the container
-    /// @returns Reference to the IocContainer, for chaining operations
     template <class T>
-    IocContainer& bindInstance(const std::string& name, std::shared_ptr<T> instance)
+    static HolderPtr<T> toHolderPtr(std::shared_ptr<T> instance)
     {
-        return bindInstanceInternal<T>(name, std::move(instance));
+        return instance;
     }
 
-    /// Registers an instance for a given type. This version performs a copy of the
-    /// object, using the copy
-    ///     constructor and will manage lifetime via the Holder (shared_ptr)
-    /// @tparam T The type of the instance
+    /// Registers a holder for a given type key
+    /// @param[in] typeKey The type key to register the holder under
     /// @param[in] name The name of the instance
-    /// @param[in] instance The instance to be held within the container
+    /// @param[in] holder The holder of the instance
     /// @returns Reference to the IocContainer, for chaining operations
-    template <class T>
-    std::enable_if_t<!is_reference_wrapper_v<T>, IocContainer&> bindValue(const std::string& name,
-                                                                          value_wrapper<T> instance)
+    IocContainer& bindInstanceInternal(TypeKey typeKey, NameKey name, Holder holder)
     {
-        return bindValue(name, instance.move());
+        Lock lock(mutex_);
+
+        Holder& slot = *reserveInstance(typeKey, name).first;
+
+        retire(slot.assign(std::move(holder)));
+        recordCreation(slot);
+        return *this;
     }
 
-    /// Registers an instance for a given type. This version performs a copy of the
-    /// object, using the copy
-    ///     constructor and will manage lifetime via the Holder (shared_ptr)
-    /// @tparam T The type of the instance
+    /// Returns the slot for an instance, which is created empty if it doesn't exist yet.
+    /// Unnamed instances are held in a map indexed by the index of the type. The slot remains
+    /// valid until the instance is erased
+    /// @param[in] typeKey The type key of the instance
     /// @param[in] name The name of the instance
-    /// @param[in] instance The instance to be held within the container
-    /// @returns Reference to the IocContainer, for chaining operations
-    template <class T>
-    std::enable_if_t<!is_wrapped_v<T>, IocContainer&> bindValue(const std::string& name, T instance)
+    /// @returns The slot, and whether it was empty
+    std::pair<Holder*, bool> reserveInstance(TypeKey typeKey, NameKey name)
     {
-        return bindInstance<T>(name, std::make_shared<T>(std::move(instance)));
+        if (name.str().empty())
+        {
+            auto& holder = unnamedInstances_[typeKey.index()];
+            return {&holder, holder.empty()};
+        }
+
+        auto [iter, inserted] = registeredInstances_[typeKey].try_emplace(name);
+        return {&iter->second.value, inserted};
     }
 
-    /// Utility method to erase an existing instance from the container
-    /// @tparam T The type of the instance
+    /// Registers a holder for a given type key under an integer index
+    /// @param[in] typeKey The type key to register the holder under
+    /// @param[in] index The index of the instance
+    /// @param[in] holder The holder of the instance
     /// @returns Reference to the IocContainer, for chaining operations
-    template <class T>
-    IocContainer& eraseInstance()
+    IocContainer& bindIndexedInternal(TypeKey typeKey, std::size_t index, Holder holder)
     {
-        return eraseInstance<T>("");
+        Lock lock(mutex_);
+
+        auto& instances = indexedInstances_[typeKey];
+
+        if (index >= instances.size())
+        {
+            instances.resize(index + 1);
+        }
+
+        retire(std::exchange(instances[index], std::move(holder)));
+        recordCreation(instances[index]);
+        return *this;
     }
 
-    /// Utility method to erase an existing instance from the container
-    /// @tparam T The type of the instance
+    /// Erases an instance, and its type from the container once it has no instances left
+    /// @param[in] typeKey The type key the instance is registered under
     /// @param[in] name The name of the instance
     /// @returns Reference to the IocContainer, for chaining operations
-    template <class T>
-    IocContainer& eraseInstance(const std::string& name)
+    IocContainer& eraseInstanceInternal(TypeKey typeKey, NameKey name)
     {
         Lock lock(mutex_);
 
-        auto typeName = getType<T>();
-        auto iter = registeredInstances_.find(typeName);
+        if (name.str().empty())
+        {
+            if (Holder* holder = unnamedInstances_.find(typeKey.index()))
+            {
+                retire(std::exchange(*holder, Holder()));
+            }
+
+            return *this;
+        }
+
+        auto iter = registeredInstances_.find(typeKey);
 
         if (iter != registeredInstances_.end())
         {
             auto innerIter = iter->second.find(name);
             if (innerIter != iter->second.end())
             {
+                retire(std::move(innerIter->second.value));
                 iter->second.erase(innerIter);
 
                 // If we have no elements left, we might as well
@@ -538,530 +4893,509 @@ public:
         return *this;
     }
 
-    /// Creates an instance using a registered factory
-    /// @tparam T The type of the instance
-    /// @returns Reference to the IocContainer, for chaining operations
-    /// @throws IocException If object is not contained within the container and there is
-    /// no factory
-    ///     registered to create it
-    template <class T, class... TArgs>
-    std::unique_ptr<T> createWithoutStoring [[nodiscard]] (TArgs&&... args)
+    // Releases an instance that was erased or replaced, unless the reclamation is deferred,
+    // in which case it is kept until the next call to reclaim
+    void retire(Holder holder)
     {
-        return createByNameWithoutStoring<T>("", std::forward<TArgs>(args)...);
+        if (reclamation_ == Reclamation::Deferred && !holder.empty())
+        {
+            retiredInstances_.push_back(std::move(holder));
+        }
     }
 
-    /// Creates an instance using a registered factory and assign it the specified name
-    /// @tparam T The type of the instance
-    /// @returns Reference to the IocContainer, for chaining operations
-    /// @throws IocException If object is not contained within the container and there is
-    /// no factory
-    ///     registered to create it
-    template <class T, class... TArgs>
-    std::unique_ptr<T> createByNameWithoutStoring
-        [[nodiscard]] (const std::string& name, TArgs&&... args)
+    // Records the order in which instances are bound, if they are to be released in reverse
+    void recordCreation(const Holder& holder)
     {
-        using boost::format;
-        using boost::str;
+        if (shutdownPolicy_ != ShutdownPolicy::DependencyOrdered)
+        {
+            return;
+        }
 
-        auto typeName = getType<T>();
+        // Forget the instances which were already released, before growing the record
+        if (creationOrder_.size() == creationOrder_.capacity())
+        {
+            creationOrder_.erase(std::remove_if(creationOrder_.begin(),
+                                                creationOrder_.end(),
+                                                [](const auto& owner) { return owner.expired(); }),
+                                 creationOrder_.end());
+        }
 
-        if (registeredFactories_.count(typeName))
+        if (auto owner = holder.owner())
         {
-            // See if there is a factory that can create this object
-            const auto& holder = registeredFactories_.at(typeName);
-            auto holderType = boost::core::demangle(holder.type().name());
+            creationOrder_.push_back(owner);
+        }
+    }
 
-            auto expectedHolderType = getType<Factory<T, TArgs...>>();
-            auto sharedHolderType = getType<SharedFactory<T, TArgs...>>();
+    // Releases the instances in the reverse of the order they were bound in. The recorded
+    // instances are kept alive while the containers are cleared, which releases any others
+    void releaseInCreationOrder()
+    {
+        std::vector<std::shared_ptr<void>> owners;
+        owners.reserve(creationOrder_.size());
 
-            if (holderType == sharedHolderType)
-            {
-                static const format fmt("Shared factory cannot return a unique ptr, "
-                                        "please use createByNameWithoutStoringShared instead."
-                                        "\n\tExpected Factory: %1%\n\tActual Factory  : %2%");
-                BOOST_THROW_EXCEPTION(IocException() << StringInfo(str(
-                                          format(fmt) % expectedHolderType % sharedHolderType)));
-            }
-            else if (holderType != expectedHolderType)
+        for (const auto& owner : creationOrder_)
+        {
+            if (auto locked = owner.lock())
             {
-                static const format fmt("Registered factory is of an unknown signature. "
-                                        "Please verify signature."
-                                        "\n\tExpected Factory: %1%\n\tActual Factory  : %2%");
-                BOOST_THROW_EXCEPTION(IocException() << StringInfo(
-                                          str(format(fmt) % expectedHolderType % holderType)));
+                owners.push_back(std::move(locked));
             }
-
-            auto factory = boost::any_cast<Factory<T, TArgs...>>(holder);
-            return std::unique_ptr<T>(factory(std::forward<TArgs>(args)...));
         }
 
-        if (parent_ == nullptr)
+        creationOrder_.clear();
+        retiredInstances_.clear();
+        indexedInstances_.clear();
+        unnamedInstances_.clear();
+        registeredInstances_.clear();
+
+        while (!owners.empty())
         {
-            static const format fmt("No registered factory exists which can create "
-                                    "this object. "
-                                    "\n\tExpected Holder Type:  %1%\n\tName                : %2%");
-            BOOST_THROW_EXCEPTION(IocException()
-                                  << StringInfo(str(format(fmt) % getType<T>() % name)));
+            owners.pop_back();
         }
-
-        return parent_->createByNameWithoutStoring<T>(name, std::forward<TArgs>(args)...);
     }
 
-    /// Creates an instance using a registered factory
-    /// @tparam T The type of the instance
-    /// @returns Reference to the IocContainer, for chaining operations
-    /// @throws IocException If object is not contained within the container and there is
-    /// no factory
-    ///     registered to create it
-    template <class T, class... TArgs>
-    std::shared_ptr<T> createWithoutStoringShared [[nodiscard]] (TArgs&&... args)
+    // Abandons the instances and factories of the container without releasing them
+    void leak()
     {
-        return createByNameWithoutStoringShared<T>("", std::forward<TArgs>(args)...);
+        struct Leaked
+        {
+            RegisteredFactories factories;
+            RegisteredInstances instances;
+            UnnamedMap unnamedInstances;
+            IndexedInstances indexedInstances;
+            std::vector<Holder> retiredInstances;
+        };
+
+        static_cast<void>(new (std::nothrow) Leaked{std::move(registeredFactories_),
+                                                    std::move(registeredInstances_),
+                                                    std::move(unnamedInstances_),
+                                                    std::move(indexedInstances_),
+                                                    std::move(retiredInstances_)});
     }
 
-    /// Creates an instance using a registered factory and assign it the specified name
-    /// @tparam T The type of the instance
-    /// @returns Reference to the IocContainer, for chaining operations
-    /// @throws IocException If object is not contained within the container and there is
-    /// no factory
-    ///     registered to create it
-    template <class T, class... TArgs>
-    std::shared_ptr<T> createByNameWithoutStoringShared
-        [[nodiscard]] (const std::string& name, TArgs&&... args)
+    // Registers the invoker of a factory under the given type and name
+    template <class T, class TInvoker>
+    IocContainer& registerInvoker(NameKey name, std::shared_ptr<TInvoker> invoker)
     {
-        using boost::format;
-        using boost::str;
+        addInvoker<T>(name, std::move(invoker));
 
-        auto typeName = getType<T>();
+        // The factory may satisfy lookups that missed before, in this container or any of its
+        // descendants
+        factoryGeneration_.fetch_add(1, std::memory_order_release);
+        return *this;
+    }
 
-        if (registeredFactories_.count(typeName))
-        {
-            // See if there is a factory that can create this object
-            const auto& holder = registeredFactories_.at(typeName);
-            auto holderType = boost::core::demangle(holder.type().name());
+    // Stores the invoker of a factory, without invalidating cached factory misses
+    template <class T, class TInvoker>
+    void addInvoker(NameKey name, std::shared_ptr<TInvoker> invoker)
+    {
+        Lock lock(mutex_);
 
-            auto expectedHolderType = getType<SharedFactory<T, TArgs...>>();
-            std::string uniqueHolderType = getType<Factory<T, TArgs...>>();
+        auto& overloads = registeredFactories_[getType<T>()][name];
+        overloads.insert_or_assign(getType<TInvoker>(), Holder(std::move(invoker)));
+    }
 
-            if (holderType == uniqueHolderType)
-            {
-                auto factory = boost::any_cast<Factory<T, TArgs...>>(holder);
-                return std::move(factory(std::forward<TArgs>(args)...));
-            }
-            else
-            {
-                auto factory = boost::any_cast<SharedFactory<T, TArgs...>>(holder);
-                return factory(std::forward<TArgs>(args)...);
-            }
-        }
+    // Sums the factory generations of this container and its ancestors. Each only ever
+    // increases, so the sum changes whenever a factory is registered anywhere in the chain,
+    // while registrations in unrelated containers leave it alone
+    std::uint64_t chainGeneration [[nodiscard]] () const noexcept
+    {
+        std::uint64_t generation = 0;
 
-        if (parent_ == nullptr)
+        for (const auto* container = this; container != nullptr; container = container->parent_)
         {
-            static const format fmt("No registered factory exists which can create "
-                                    "this object. "
-                                    "\n\tExpected Holder Type:  %1%\n\tName                : %2%");
-            BOOST_THROW_EXCEPTION(IocException()
-                                  << StringInfo(str(format(fmt) % getType<T>() % name)));
+            generation += container->factoryGeneration_.load(std::memory_order_acquire);
         }
 
-        return parent_->createByNameWithoutStoring<T>(name, std::forward<TArgs>(args)...);
+        return generation;
     }
 
-    /// Creates an instance using a registered factory
-    /// @tparam T The type of the instance
-    /// @returns Reference to the IocContainer, for chaining operations
-    /// @throws IocException If object is not contained within the container and there is
-    /// no factory
-    ///     registered to create it
+    // Helper to get types in a consistent way
+    template <class T>
+    TypeKey getType [[nodiscard]] () const
+    {
+        return TypeKey::of<T>();
+    }
+
+    // Distinct type for each pair of a type and a tag, which only serves as their key
+    template <class T, class Tag>
+    struct Tagged
+    {
+    };
+
+    // Helper to get the key of a tagged type, which is distinct from that of the type
+    template <class T, class Tag>
+    TypeKey getType [[nodiscard]] () const
+    {
+        return TypeKey::of<Tagged<T, Tag>>();
+    }
+
+    // Helper to get types in a consistent way
+    template <class T>
+    TypeKey getType [[nodiscard]] (const T&) const
+    {
+        return getType<T>();
+    }
+
+    // Internal helper method for finding the factory which can be invoked with the given
+    // arguments. The closest container in the parent chain that has factories for the type
+    // provides it. The factory is shared, so it stays valid while it is being invoked
     template <class T, class... TArgs>
-    IocContainer& create(TArgs&&... args)
+    std::shared_ptr<const FactoryInvoker<T, std::decay_t<TArgs>...>> findFactory
+        [[nodiscard]] (NameKey name) const
     {
-        return createByName<T>("", std::forward<TArgs>(args)...);
+        auto invoker = lookupFactory<T, TArgs...>(name);
+
+        if (!invoker)
+        {
+            raiseFactoryError<T, TArgs...>(invoker.error(), name);
+        }
+
+        return std::move(invoker).value();
     }
 
-    /// Creates an instance using a registered factory and assign it the specified name
-    /// @tparam T The type of the instance
-    /// @returns Reference to the IocContainer, for chaining operations
-    /// @throws IocException If object is not contained within the container and there is
-    /// no factory
-    ///     registered to create it
+    // Version of findFactory which reports failures as an ErrorCode, rather than raising them
     template <class T, class... TArgs>
-    IocContainer& createByName(const std::string& name, TArgs&&... args)
+    Result<std::shared_ptr<const FactoryInvoker<T, std::decay_t<TArgs>...>>> lookupFactory
+        [[nodiscard]] (NameKey name) const
     {
-        using boost::format;
-        using boost::str;
+        using Invoker = FactoryInvoker<T, std::decay_t<TArgs>...>;
+
+        const auto typeName = getType<T>();
+        const auto signature = getType<Invoker>();
 
-        auto typeName = getType<T>();
+        // Types that no container in the chain has a factory for are remembered, until the
+        // next factory is registered in this container or one of its ancestors, so repeated
+        // misses don't search the factories of the chain
+        const auto generation = chainGeneration();
 
-        if (registeredFactories_.count(typeName))
         {
-            const auto& holder = registeredFactories_.at(typeName);
-            auto holderType = boost::core::demangle(holder.type().name());
-            auto expectedHolderType = getType<SharedFactory<T, TArgs...>>();
+            Lock lock(mutex_);
 
-            if (holderType == expectedHolderType)
-            {
-                auto factory = boost::any_cast<SharedFactory<T, TArgs...>>(holder);
-                std::shared_ptr<T> inst(factory(std::forward<TArgs>(args)...));
-                // See if there is a factory that can create this object
-                bindInstance(name, std::move(inst));
-            }
-            else
+            auto miss = factoryMisses_.find(typeName);
+
+            if (miss != factoryMisses_.end() && miss->second == generation)
             {
-                auto factory = boost::any_cast<Factory<T, TArgs...>>(holder);
-                std::unique_ptr<T> inst(factory(std::forward<TArgs>(args)...));
-                // See if there is a factory that can create this object
-                bindInstance(name, std::move(inst));
+                return ErrorCode::NoFactory;
             }
         }
-        else
+
+        for (const auto* container = this; container != nullptr; container = container->parent_)
         {
-            if (parent_ == nullptr)
+            Lock lock(container->mutex_);
+
+            auto iter = container->registeredFactories_.find(typeName);
+
+            if (iter == container->registeredFactories_.end())
+            {
+                continue;
+            }
+
+            // The signature key is known at compile time, so selecting the overload is a
+            // single hash lookup. Prefer the factory registered under the name, and
+            // otherwise fall back to the unnamed one
+            const auto& namedFactories = iter->second;
+
+            for (const auto factoryName : {name, NameKey()})
             {
-                static const format fmt(
-                    "No registered factory exists which can create "
-                    "this object. "
-                    "\n\tExpected Holder Type:  %1%\n\tName                : %2%");
-                BOOST_THROW_EXCEPTION(IocException()
-                                      << StringInfo(str(format(fmt) % getType<T>() % name)));
+                auto named = namedFactories.find(factoryName);
+
+                if (named != namedFactories.end())
+                {
+                    const auto& overloads = named->second.value;
+                    auto overload = overloads.find(signature);
+
+                    if (overload != overloads.end())
+                    {
+                        return std::shared_ptr<const Invoker>(
+                            overload->second.template getShared<Invoker>());
+                    }
+                }
             }
 
-            parent_->createByName<T>(name, std::forward<TArgs>(args)...);
+            return ErrorCode::UnknownSignature;
         }
 
-        return *this;
-    }
+        Lock lock(mutex_);
 
-    /// Checks whether the container holds an instance of that particular type
-    /// @tparam T The type of the instance
-    /// @returns \c true if contains an instance of that type; \c false otherwise
-    template <class T>
-    bool contains [[nodiscard]] () const
-    {
-        return contains<T>("");
+        factoryMisses_.insert_or_assign(typeName, generation);
+        return ErrorCode::NoFactory;
     }
 
-    /// Checks whether the container holds an instance or factory of that particular type
-    /// and particular name
-    /// @tparam T The type of the instance
-    /// @param[in] name The name of the instance
-    /// @returns \c true if contains an instance of that type; \c false otherwise
-    template <class T>
-    bool contains [[nodiscard]] (const std::string& name) const
+    // Raises the error of a failed factory lookup, describing the registered factories
+    template <class T, class... TArgs>
+    [[noreturn]] void raiseFactoryError(ErrorCode error, NameKey name) const
     {
-        Lock lock(mutex_);
+        using detail::format;
+        using detail::str;
+        using Invoker = FactoryInvoker<T, std::decay_t<TArgs>...>;
 
         const auto typeName = getType<T>();
 
-        auto iter = registeredInstances_.find(typeName);
-
-        if (iter != registeredInstances_.end())
+        for (const auto* container = this;
+             container != nullptr && error == ErrorCode::UnknownSignature;
+             container = container->parent_)
         {
-            const auto& innerInstanceMap = iter->second;
+            Lock lock(container->mutex_);
 
-            const auto& innerIter = innerInstanceMap.find(name);
+            auto iter = container->registeredFactories_.find(typeName);
 
-            if (innerIter != innerInstanceMap.end())
+            if (iter == container->registeredFactories_.end())
+            {
+                continue;
+            }
+
+            std::string registered;
+
+            for (const auto& named : iter->second)
             {
-                return true;
+                for (const auto& overload : named.second.value)
+                {
+                    registered += "\n\t\t\"" + named.second.name + "\": " + overload.first.name();
+                }
             }
+
+            static const format fmt("Registered factory is of an unknown signature. "
+                                    "Please verify signature."
+                                    "\n\tExpected Factory: %1%\n\tName            : %2%"
+                                    "\n\tActual Factories:%3%");
+            CPPINVERT_RAISE(
+                ErrorCode::UnknownSignature,
+                str(format(fmt) % getType<Invoker>().name() % name.str() % registered));
         }
 
-        return registeredFactories_.count(typeName) > 0;
+        static const format fmt("No registered factory exists which can create "
+                                "this object. "
+                                "\n\tExpected Holder Type:  %1%\n\tName                : %2%");
+        CPPINVERT_RAISE(ErrorCode::NoFactory, str(format(fmt) % typeName.name() % name.str()));
     }
 
-    /// Returns a copy of the object from within the IOC container. This should only be
-    /// used
-    ///     if the object is copy-constructible
-    /// @tparam T The type of the instance
-    /// @returns The instance of the object from within the IOC container
-    /// @throws IocException If object is not contained within the container and there is
-    /// no factory
-    ///     registered to create it
-    template <class T>
-    T get [[nodiscard]] () const
+    // Reads the instance of a holder that was found with the lock held. The holder may be
+    // replaced as soon as the lock is released, so it is read first. Holders which resolve
+    // a lifetime are the exception, since resolving may create the instance. They are read
+    // through a copy after the lock is released, which keeps the lifetime alive
+    template <class TRead>
+    static auto read [[nodiscard]] (const Holder& holder, Lock& lock, TRead reader)
     {
-        return get<T>("");
+        if (!holder.resolves())
+        {
+            return reader(holder);
+        }
+
+        const Holder link = holder;
+        lock.unlock();
+        return reader(link);
     }
 
-    /// Returns a pointer to the object from within the IOC container. You should NOT
-    /// explicitly
-    //      delete the pointer if the object was created with any ownership semantics
-    /// @tparam T The type of the instance
-    /// @returns The instance of the object from within the IOC container
-    /// @throws IocException If object is not contained within the container and there is
-    /// no factory
-    ///     registered to create it
+    // Readers for the instance of a holder, used by the get methods
     template <class T>
-    T* getPtr [[nodiscard]] () const
+    static T* pointerTo [[nodiscard]] (const Holder& holder)
     {
-        return getPtr<T>("");
+        return holder.template get<T>();
     }
 
-    /// Returns a reference to the object from within the IOC container. This is ideal if
-    /// you inserted
-    ///     an instance via a ref/cref semantic or a unique_ptr semantic
-    /// @tparam T The type of the instance
-    /// @returns The instance of the object from within the IOC container
-    /// @throws IocException If object is not contained within the container and there is
-    /// no factory
-    ///     registered to create it
     template <class T>
-    T& getRef [[nodiscard]] () const
+    static T copyOf [[nodiscard]] (const Holder& holder)
     {
-        return getRef<T>("");
+        return *holder.template get<T>();
     }
 
-    /// Returns a shared_ptr to the object from within the IOC container. This is ideal if
-    /// you inserted
-    ///     the object via the shared_ptr<> mechanism, because you intend to share
-    ///     ownership
-    /// @tparam T The type of the instance
-    /// @returns The instance of the object from within the IOC container
-    /// @throws IocException If object is not contained within the container and there is
-    /// no factory
-    ///     registered to create it
     template <class T>
-    std::shared_ptr<T> getShared [[nodiscard]] () const
+    static std::shared_ptr<T> sharedPtrTo [[nodiscard]] (const Holder& holder)
     {
-        return getShared<T>("");
+        return holder.template getShared<T>();
     }
 
-    /// Returns a copy of the object from within the IOC container. This should only be
-    /// used
-    ///     if the object is copy-constructible
-    /// @tparam T The type of the instance
-    /// @param name The name of the instance to retrieve
-    /// @returns The instance of the object from within the IOC container
-    /// @throws IocException If object is not contained within the container and there is
-    /// no factory
-    ///     registered to create it
+    // Internal helper method for finding the registered instance, which is created first if
+    // this container has a factory for the type. This must be called with the lock held,
+    // which must remain held while the holder is read
     template <class T>
-    T get [[nodiscard]] (const std::string& name) const
+    Result<const Holder*> lookup [[nodiscard]] (NameKey name) const
     {
-        using boost::format;
-        using boost::str;
+        const auto typeName = getType<T>();
+        const Holder* holder = findInstance(typeName, name);
 
-        Lock lock(mutex_);
+        if (holder == nullptr && registeredFactories_.count(typeName))
+        {
+            // Attempt to create the object
+            auto error = const_cast<IocContainer*>(this)->tryCreateByName<T>(name);
 
-        const auto item = find<T>(name);
+            if (error != ErrorCode::None)
+            {
+                return error;
+            }
 
-        auto expectedHolderType = getType<HolderPtr<T>>();
+            holder = findInstance(typeName, name);
+        }
 
-        if (!item.first)
+        if (holder == nullptr)
         {
-            static const format fmt("Item not found by type and name. \n\tExpected "
-                                    "Holder Type:  %1%\n\tName                : %2%");
-            BOOST_THROW_EXCEPTION(IocException()
-                                  << StringInfo(str(format(fmt) % expectedHolderType % name)));
+            return ErrorCode::NotFound;
         }
 
-        auto innerIter = item.second;
-
-        const Holder& holder = innerIter->second;
-        auto holderType = boost::core::demangle(holder.type().name());
-
-        if (holderType == expectedHolderType)
+        if (holder->type() != typeName)
         {
-            return *boost::any_cast<HolderPtr<T>>(holder);
+            return ErrorCode::TypeMismatch;
         }
 
-        static const format fmt("Holder type doesn't match expected holder type %1% != "
-                                "%2%");
-        BOOST_THROW_EXCEPTION(IocException()
-                              << StringInfo(str(format(fmt) % holderType % expectedHolderType)));
-    }
-
-    /// Returns a pointer to the object from within the IOC container. You should NOT
-    /// explicitly
-    //      delete the pointer if the object was created with any ownership semantics
-    /// @tparam T The type of the instance
-    /// @param name The name of the instance to retrieve
-    /// @returns The instance of the object from within the IOC container
-    /// @throws IocException If object is not contained within the container and there is
-    /// no factory
-    ///     registered to create it
-    template <class T>
-    T* getPtr [[nodiscard]] (const std::string& name) const
-    {
-        return boost::any_cast<HolderPtr<T>>(getInternal<T>(name)).get();
-    }
-
-    /// Returns a reference to the object from within the IOC container. This is ideal if
-    /// you inserted
-    ///     an instance via a ref/cref semantic or a unique_ptr semantic
-    /// @tparam T The type of the instance
-    /// @param name The name of the instance to retrieve
-    /// @returns The instance of the object from within the IOC container
-    /// @throws IocException If object is not contained within the container and there is
-    /// no factory
-    ///     registered to create it
-    template <class T>
-    T& getRef [[nodiscard]] (const std::string& name) const
-    {
-        return *boost::any_cast<HolderPtr<T>>(getInternal<T>(name)).get();
-    }
-
-    /// Returns a shared_ptr to the object from within the IOC container. This is ideal if
-    /// you inserted
-    ///     the object via the shared_ptr<> mechanism, because you intend to share
-    ///     ownership
-    /// @tparam T The type of the instance
-    /// @param name The name of the instance to retrieve
-    /// @returns The instance of the object from within the IOC container
-    /// @throws IocException If object is not contained within the container and there is
-    /// no factory
-    ///     registered to create it
-    template <class T>
-    std::shared_ptr<T> getShared [[nodiscard]] (const std::string& name) const
-    {
-        return boost::any_cast<HolderPtr<T>>(getInternal<T>(name));
+        return holder;
     }
 
-    // Retrieve a static constant instance of this object for cases where we are calling
-    // through to an IOC container, but have nothing to put in it. This will ensure the
-    // correct object lifetime
-    static const IocContainer& emptyContainer()
+    // Internal helper method for finding a registered instance by its key, which must be
+    // called with the lock held
+    const Holder* findInstance [[nodiscard]] (TypeKey typeKey, NameKey name) const
     {
-        static const IocContainer empty;
-
-        return empty;
-    }
+        if (name.str().empty())
+        {
+            const Holder* holder = unnamedInstances_.find(typeKey.index());
+            return holder != nullptr && !holder->empty() ? holder : nullptr;
+        }
 
-private:
-    using RegisteredFactories = std::unordered_map<std::string, boost::any>;
+        auto iter = registeredInstances_.find(typeKey);
 
-    using Holder = boost::any;
+        if (iter != registeredInstances_.end())
+        {
+            const auto& innerInstanceMap = iter->second;
 
-    template <class T>
-    using HolderPtr = std::shared_ptr<T>;
+            const auto& innerIter = innerInstanceMap.find(name);
 
-    using InnerRegisteredInstanceMap = std::unordered_map<std::string, Holder>;
-    using RegisteredInstances = std::unordered_map<std::string, InnerRegisteredInstanceMap>;
+            if (innerIter != innerInstanceMap.end())
+            {
+                return &innerIter->second.value;
+            }
+        }
 
-    using Mutex = std::recursive_mutex;
-    using Lock = std::unique_lock<Mutex>;
+        return nullptr;
+    }
 
-    /// Registers an instance for a given type. This version will take in a
-    /// holder pointer, which will become a shared_ptr if it isn't already and share
-    /// lifetime with any other shared_ptrs that reference it
-    /// @tparam T The type of the instance
-    /// @tparam T2 The wrapper around the instance
-    /// @param[in] name The name of the instance
-    /// @param[in] instance The instance to be held within the container
-    /// @returnsReference to the IocContainer, for chaining operations
-    template <class T>
-    IocContainer& bindInstanceInternal(std::string name, HolderPtr<T> instance)
+    // Internal helper method for finding a tagged instance, which must be called with the
+    // lock held. Tagged instances can only be bound as their type, so the holder needs no
+    // type check
+    template <class T, class Tag>
+    Result<const Holder*> lookupTagged [[nodiscard]] () const
     {
-        Lock lock(mutex_);
+        const Holder* holder = findInstance(getType<T, Tag>(), NameKey());
 
-        auto typeName = getType<T>();
-        auto& innerMap = registeredInstances_[std::move(typeName)];
-        innerMap.insert_or_assign(name, Holder(std::move(instance)));
-        return *this;
-    }
+        if (holder == nullptr)
+        {
+            return ErrorCode::NotFound;
+        }
 
-    // Helper to get types in a consistent way
-    template <class T>
-    std::string getType [[nodiscard]] () const
-    {
-        return boost::core::demangle(typeid(std::decay_t<T>).name());
+        return holder;
     }
 
-    // Helper to get types in a consistent way
-    template <class T>
-    std::string getType [[nodiscard]] (const T&) const
+    // Internal helper method for the tagged get methods, which reads the instance with the
+    // given reader
+    template <class T, class Tag, class TRead>
+    auto getTaggedInternal [[nodiscard]] (TRead reader) const
     {
-        return getType<T>();
-    }
+        using detail::format;
+        using detail::str;
 
-    // Internal helper method for finding the registered instance
-    template <class T>
-    std::pair<bool, InnerRegisteredInstanceMap::iterator> find
-        [[nodiscard]] (const std::string& name, bool checkFactory = true)
-    {
         Lock lock(mutex_);
+        auto holder = lookupTagged<T, Tag>();
 
-        // Internally does a const_cast to maximize code reuse
-        auto res = const_cast<const IocContainer*>(this)->find<T>(name, checkFactory);
+        if (!holder)
+        {
+            static const format fmt("Item not found by type and tag. \n\tExpected "
+                                    "Holder Type:  %1%\n\tTag                 : %2%");
+            CPPINVERT_RAISE(ErrorCode::NotFound,
+                            str(format(fmt) % getType<T>().name() % getType<Tag>().name()));
+        }
 
-        return std::make_pair(res.first,
-                              const_cast<InnerRegisteredInstanceMap::iterator>(res.second));
+        return read(**holder, lock, reader);
     }
 
-    // Internal helper method for finding the registered instance
-    template <class T>
-    std::pair<bool, InnerRegisteredInstanceMap::const_iterator> find
-        [[nodiscard]] (const std::string& name, bool checkFactory = true) const
+    // Internal helper method for finding an indexed instance, which must be called with the
+    // lock held
+    const Holder* findIndexed [[nodiscard]] (TypeKey typeKey, std::size_t index) const
     {
-        Lock lock(mutex_);
+        auto iter = indexedInstances_.find(typeKey);
 
-        auto result = std::make_pair(false, InnerRegisteredInstanceMap::const_iterator());
+        if (iter == indexedInstances_.end() || index >= iter->second.size() ||
+            iter->second[index].empty())
+        {
+            return nullptr;
+        }
 
-        const auto typeName = getType<T>();
+        return &iter->second[index];
+    }
 
-        auto iter = registeredInstances_.find(typeName);
+    // Internal helper method for finding an indexed instance, which must be called with the
+    // lock held
+    template <class T>
+    Result<const Holder*> lookupIndexed [[nodiscard]] (std::size_t index) const
+    {
+        const Holder* holder = findIndexed(getType<T>(), index);
 
-        if (iter != registeredInstances_.end())
+        if (holder == nullptr)
         {
-            const auto& innerInstanceMap = iter->second;
+            return ErrorCode::NotFound;
+        }
 
-            const auto& innerIter = innerInstanceMap.find(name);
+        return holder;
+    }
 
-            if (innerIter != innerInstanceMap.end())
-            {
-                return std::make_pair(true, innerIter);
-            }
-        }
+    // Internal helper method for the indexed get methods, which reads the instance with the
+    // given reader
+    template <class T, class TRead>
+    auto getIndexedInternal [[nodiscard]] (std::size_t index, TRead reader) const
+    {
+        using detail::format;
+        using detail::str;
 
-        if (checkFactory && registeredFactories_.count(typeName))
-        {
-            // Attempt to create the object - Should throw if this also fails
-            const_cast<IocContainer*>(this)->createByName<T>(name);
+        Lock lock(mutex_);
+        auto holder = lookupIndexed<T>(index);
 
-            // Avoid infinite recursion, in case it's still not found
-            return find<T>(name, false);
+        if (!holder)
+        {
+            static const format fmt("Item not found by type and index. \n\tExpected "
+                                    "Holder Type:  %1%\n\tIndex               : %2%");
+            CPPINVERT_RAISE(ErrorCode::NotFound,
+                            str(format(fmt) % getType<T>().name() % index));
         }
 
-        return result;
+        return read(**holder, lock, reader);
     }
 
-    // Internal helper method for the get method
-    template <class T>
-    Holder getInternal [[nodiscard]] (const std::string& name) const
+    // Internal helper method for the get methods, which reads the type-checked instance
+    // with the given reader
+    template <class T, class TRead>
+    auto getInternal [[nodiscard]] (NameKey name, TRead reader) const
     {
-        using boost::format;
-        using boost::str;
+        using detail::format;
+        using detail::str;
 
         Lock lock(mutex_);
+        auto holder = lookup<T>(name);
+        auto expectedHolderType = getType<T>();
 
-        const auto item = find<T>(name);
-
-        auto expectedHolderType = getType<HolderPtr<T>>();
+        if (holder)
+        {
+            return read(**holder, lock, reader);
+        }
 
-        if (!item.first)
+        if (holder.error() == ErrorCode::NotFound)
         {
             static const format fmt("Item not found by type and name. \n\tExpected "
                                     "Holder Type:  %1%\n\tName                : %2%");
-            BOOST_THROW_EXCEPTION(IocException()
-                                  << StringInfo(str(format(fmt) % expectedHolderType % name)));
+            CPPINVERT_RAISE(ErrorCode::NotFound,
+                            str(format(fmt) % expectedHolderType.name() % name.str()));
         }
 
-        auto innerIter = item.second;
-
-        const Holder& holder = innerIter->second;
-
-        auto holderType = boost::core::demangle(holder.type().name());
-
-        if (holderType == expectedHolderType)
+        if (holder.error() == ErrorCode::TypeMismatch)
         {
-            return innerIter->second;
+            const Holder* mismatched = findInstance(expectedHolderType, name);
+            const auto actualHolderType = mismatched ? mismatched->type() : TypeKey();
+
+            static const format fmt("Holder type doesn't match expected holder type %1% != "
+                                    "%2%");
+            CPPINVERT_RAISE(
+                ErrorCode::TypeMismatch,
+                str(format(fmt) % actualHolderType.name() % expectedHolderType.name()));
         }
 
-        static const format fmt("Holder type doesn't match expected holder type %1% != "
-                                "%2%");
-        BOOST_THROW_EXCEPTION(IocException()
-                              << StringInfo(str(format(fmt) % holderType % expectedHolderType)));
+        // Creating the instance failed
+        raiseFactoryError<T>(holder.error(), name);
     }
 
     // Pointer to the parent container
@@ -1070,9 +5404,43 @@ private:
     // Container of registered factories
     RegisteredFactories registeredFactories_;
 
+    // Types without a factory anywhere in the chain, with the chain generation at the time
+    mutable std::unordered_map<TypeKey, std::uint64_t, TypeKey::Hash> factoryMisses_;
+
+    // Counts the factories registered in this container
+    std::atomic<std::uint64_t> factoryGeneration_;
+
     // Container of registered instances
     RegisteredInstances registeredInstances_;
 
+    // Container of unnamed instances, indexed by the index of their type key
+    UnnamedMap unnamedInstances_;
+
+    // Container of instances registered by index
+    IndexedInstances indexedInstances_;
+
+    // When instances that are erased or replaced are released
+    Reclamation reclamation_;
+
+    // Instances that were erased or replaced, which are released by reclaim
+    std::vector<Holder> retiredInstances_;
+
+    // How the instances are released when the container is destroyed
+    ShutdownPolicy shutdownPolicy_;
+
+    // The instances in the order they were bound in, for the dependency ordered shutdown
+    std::vector<std::weak_ptr<void>> creationOrder_;
+
+    // The readers holding borrowed instances, which retired instances must wait for. This
+    // is created when the reclamation is first deferred
+    std::unique_ptr<detail::EpochDomain> epochs_;
+
+    // The readers, while instances can be borrowed. Borrowers read it without the lock
+    std::atomic<detail::EpochDomain*> borrowing_;
+
+    // The NUMA topology for per-node lifetimes, or null for the topology of the machine
+    std::shared_ptr<const NumaTopology> numaTopology_;
+
     // Keeps the container thread-safe
     mutable Mutex mutex_;
 };
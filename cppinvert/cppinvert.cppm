@@ -0,0 +1,63 @@
+// C++20 module interface of cppinvert, so that importers don't need to parse the header,
+// and its dependencies, in every translation unit:
+//
+//     import cppinvert;
+//
+// Macros can't be exported from a module, so IOC_NAME is only available by including
+// IocContainer.hpp. The "name"_ioc literal can be used instead
+//
+// The module is experimental. It is built by configuring with
+// -DCPPINVERT_EXPERIMENTAL_MODULE=ON, which requires CMake 3.28, and Clang 16, GCC 14 or
+// MSVC 19.36 or later. That also adds the cppinvert_test_module test, which imports it. So far
+// it has only been compiled with GCC 12 and -fmodules-ts, whose importers can't see the
+// exported using-declarations, so the test hasn't yet run with a supported compiler
+module;
+
+#include <cppinvert/IocContainer.hpp>
+
+export module cppinvert;
+
+export namespace cppinvert
+{
+
+using cppinvert::Borrowed;
+using cppinvert::ErrorCode;
+using cppinvert::forwarded_arg;
+using cppinvert::implements;
+using cppinvert::InstanceGroup;
+using cppinvert::InstanceHolder;
+using cppinvert::IocContainer;
+using cppinvert::IocException;
+using cppinvert::is_reference_wrapper;
+using cppinvert::is_reference_wrapper_v;
+using cppinvert::is_tag_v;
+using cppinvert::is_value_wrapper;
+using cppinvert::is_value_wrapper_v;
+using cppinvert::is_wrapped_v;
+using cppinvert::Lender;
+using cppinvert::mval;
+using cppinvert::NameKey;
+using cppinvert::NullDeleter;
+using cppinvert::nullDeleter_v;
+using cppinvert::NumaTopology;
+using cppinvert::Replicas;
+using cppinvert::Result;
+using cppinvert::Swappable;
+using cppinvert::ThreadLocal;
+using cppinvert::TypeKey;
+using cppinvert::val;
+using cppinvert::value_wrapper;
+
+#ifndef CPPINVERT_NO_BOOST
+using cppinvert::ErrorCodeInfo;
+using cppinvert::StringInfo;
+#endif
+
+inline namespace literals
+{
+
+using cppinvert::literals::operator""_ioc;
+
+} // literals
+
+} // cppinvert
@@ -1,11 +1,13 @@
 #include <cppinvert/IocContainer.hpp>
 
 #include <functional>
+#include <future>
 #include <iostream>
 #include <random>
 #include <thread>
 #include <unordered_set>
 
+#include <boost/core/noncopyable.hpp>
 #include <boost/format.hpp>
 
 #include <boost/test/unit_test.hpp>
@@ -18,6 +20,28 @@ using boost::str;
 
 static constexpr const bool printObjectTracker = false;
 
+// Casts to the concrete type of an instance, which is checked if RTTI is available
+template <class TDerived, class TBase>
+TDerived& downcast(TBase& instance)
+{
+#ifdef CPPINVERT_NO_RTTI
+    return static_cast<TDerived&>(instance);
+#else
+    return dynamic_cast<TDerived&>(instance);
+#endif
+}
+
+// Holds the lock of the container it is emplaced into, from when it is constructed until it
+// is told to unlock, to check which operations don't lock the container
+struct LockHolder
+{
+    LockHolder(promise<void>& locked, shared_future<void> unlocked)
+    {
+        locked.set_value();
+        unlocked.wait();
+    }
+};
+
 // This structure can be used to help track when the objects are created or destroyed,
 // so we can prove that the iocContainer is behaving correctly
 class ObjectTracker
@@ -341,9 +365,12 @@ BOOST_AUTO_TEST_CASE(testIocContainerFactoryTemplateParameterPack)
     BOOST_CHECK_EQUAL(iocContainer.size(), 0);
     IObject& a = iocContainer.create<IObject>(3, 4).getRef<IObject>();
     BOOST_CHECK_EQUAL(iocContainer.size(), 1);
+#ifndef CPPINVERT_NO_RTTI
+    // Casting from the virtual base requires RTTI
     Point& p = dynamic_cast<Point&>(a);
     BOOST_CHECK_EQUAL(p.m_x, 3);
     BOOST_CHECK_EQUAL(p.m_y, 4);
+#endif
     BOOST_CHECK_EQUAL(iocContainer.size(), 1);
 }
 
@@ -378,9 +405,12 @@ BOOST_AUTO_TEST_CASE(testIocContainerSharedFactoryTemplateParameterPack)
     BOOST_CHECK_EQUAL(iocContainer.size(), 0);
     IObject& a = iocContainer.create<IObject>(3, 4).getRef<IObject>();
     BOOST_CHECK_EQUAL(iocContainer.size(), 1);
+#ifndef CPPINVERT_NO_RTTI
+    // Casting from the virtual base requires RTTI
     Point& p = dynamic_cast<Point&>(a);
     BOOST_CHECK_EQUAL(p.m_x, 3);
     BOOST_CHECK_EQUAL(p.m_y, 4);
+#endif
     BOOST_CHECK_EQUAL(iocContainer.size(), 1);
 }
 
@@ -564,9 +594,12 @@ BOOST_AUTO_TEST_CASE(testBindInterface)
                           IocException);
 
         IValWrapper& aBaseRef = iocContainer.getRef<IValWrapper>();
+#ifndef CPPINVERT_NO_RTTI
+        // Casting from the virtual base requires RTTI
         IntWrapper& aRef = dynamic_cast<IntWrapper&>(aBaseRef);
 
         BOOST_CHECK_EQUAL(a1.val, aRef.val);
+#endif
 
         iocContainer.eraseInstance<IValWrapper>();
 
@@ -589,6 +622,1327 @@ BOOST_AUTO_TEST_CASE(testBindInterface)
                       IocException);
 }
 
+BOOST_AUTO_TEST_CASE(testInlineValueStorage)
+{
+    static_assert(InstanceHolder::isInline<size_t>, "Scalars should be stored inline");
+    static_assert(!InstanceHolder::isInline<string>, "Strings should be shared");
+
+    iocContainer.bindValue<size_t>("numHorizViewports", 2)
+        .bindValue<size_t>("numVertViewports", 4)
+        .bindValue<string>("title", "viewports");
+
+    BOOST_CHECK_EQUAL(iocContainer.size(), 3);
+    BOOST_CHECK_EQUAL(iocContainer.get<size_t>("numHorizViewports"), 2);
+    BOOST_CHECK_EQUAL(iocContainer.get<size_t>("numVertViewports"), 4);
+    BOOST_CHECK_EQUAL(iocContainer.getRef<size_t>("numVertViewports"), 4);
+    BOOST_CHECK_EQUAL(iocContainer.getPtr<size_t>("numVertViewports"),
+                      &iocContainer.getRef<size_t>("numVertViewports"));
+
+    // Inline values aren't reference counted, so the shared_ptr owns a copy
+    auto shared = iocContainer.getShared<size_t>("numHorizViewports");
+    BOOST_CHECK_EQUAL(*shared, 2);
+    BOOST_CHECK_EQUAL(shared.use_count(), 1);
+    BOOST_CHECK_EQUAL(iocContainer.getShared<string>("title").use_count(), 2);
+
+    iocContainer.bindValue<size_t>("numHorizViewports", 3);
+    BOOST_CHECK_EQUAL(iocContainer.get<size_t>("numHorizViewports"), 3);
+    BOOST_CHECK_EQUAL(*shared, 2);
+    BOOST_CHECK_THROW(int value = iocContainer.get<int>("numHorizViewports"), IocException);
+
+    iocContainer.eraseInstance<size_t>("numHorizViewports");
+    BOOST_CHECK(!iocContainer.contains<size_t>("numHorizViewports"));
+    BOOST_CHECK_EQUAL(iocContainer.size(), 2);
+}
+
+BOOST_AUTO_TEST_CASE(testEmplace)
+{
+    // Neither copyable nor movable, so can only be constructed in place
+    struct Viewport : private boost::noncopyable
+    {
+        Viewport(int width, int height, ObjectTracker& tracker)
+            : width(width)
+            , height(height)
+            , objTracker(tracker)
+        {
+            objTracker.onCreated(this);
+        }
+
+        ~Viewport()
+        {
+            objTracker.onDestroyed(this);
+        }
+
+        int width;
+        int height;
+        ObjectTracker& objTracker;
+    };
+
+    struct Throwing
+    {
+        explicit Throwing(bool shouldThrow)
+        {
+            if (shouldThrow)
+            {
+                throw runtime_error("Failed to construct");
+            }
+        }
+    };
+
+    iocContainer.emplace<Viewport>("viewport", 640, 480, objTracker)
+        .emplace<size_t>("numHorizViewports", 2);
+
+    BOOST_CHECK_EQUAL(objTracker.size(), 1);
+    BOOST_CHECK_EQUAL(iocContainer.size(), 2);
+    BOOST_CHECK_EQUAL(iocContainer.getRef<Viewport>("viewport").width, 640);
+    BOOST_CHECK_EQUAL(iocContainer.getRef<Viewport>("viewport").height, 480);
+    BOOST_CHECK_EQUAL(iocContainer.get<size_t>("numHorizViewports"), 2);
+
+    // Emplacing over an existing instance replaces it
+    iocContainer.emplace<Viewport>("viewport", 800, 600, objTracker);
+    BOOST_CHECK_EQUAL(objTracker.size(), 1);
+    BOOST_CHECK_EQUAL(iocContainer.getRef<Viewport>("viewport").width, 800);
+
+    // A failed construction releases the reserved slot, or keeps the existing instance
+    BOOST_CHECK_THROW(iocContainer.emplace<Throwing>("throwing", true), runtime_error);
+    BOOST_CHECK(!iocContainer.contains<Throwing>("throwing"));
+    iocContainer.emplace<Throwing>("throwing", false);
+    BOOST_CHECK_THROW(iocContainer.emplace<Throwing>("throwing", true), runtime_error);
+    BOOST_CHECK(iocContainer.contains<Throwing>("throwing"));
+    BOOST_CHECK_EQUAL(iocContainer.size(), 3);
+
+    iocContainer.eraseInstance<Viewport>("viewport");
+    BOOST_CHECK_EQUAL(objTracker.size(), 0);
+}
+
+BOOST_AUTO_TEST_CASE(testFactoryArgumentForwarding)
+{
+    // Counts how often it is copied or moved, to prove arguments are forwarded
+    struct CopyCounter
+    {
+        CopyCounter(int& copies, int& moves)
+            : copies(&copies)
+            , moves(&moves)
+        {
+        }
+
+        CopyCounter(const CopyCounter& rhs)
+            : copies(rhs.copies)
+            , moves(rhs.moves)
+        {
+            ++*copies;
+        }
+
+        CopyCounter(CopyCounter&& rhs)
+            : copies(rhs.copies)
+            , moves(rhs.moves)
+        {
+            ++*moves;
+        }
+
+        int* copies;
+        int* moves;
+    };
+
+    struct IRequest
+    {
+        virtual ~IRequest()
+        {
+        }
+    };
+
+    struct BufferRequest : public IRequest
+    {
+        explicit BufferRequest(const vector<char>& buffer)
+            : data(buffer.data())
+        {
+        }
+
+        const char* data;
+    };
+
+    struct OwningRequest : public IRequest
+    {
+        explicit OwningRequest(unique_ptr<vector<char>>&& buffer)
+            : buffer(move(buffer))
+        {
+        }
+
+        unique_ptr<vector<char>> buffer;
+    };
+
+    struct CountingRequest : public IRequest
+    {
+        explicit CountingRequest(CopyCounter counter)
+            : counter(move(counter))
+        {
+        }
+
+        CopyCounter counter;
+    };
+
+    IocContainer::Factory<IRequest, const vector<char>&> bufferFactory =
+        [](const vector<char>& buffer) { return make_unique<BufferRequest>(buffer); };
+    IocContainer::Factory<IRequest, unique_ptr<vector<char>>&&> owningFactory =
+        [](unique_ptr<vector<char>>&& buffer) {
+            return make_unique<OwningRequest>(move(buffer));
+        };
+
+    IocContainer& bufferContainer = iocContainer.getRef<IocContainer>("buffer");
+    IocContainer& owningContainer = iocContainer.getRef<IocContainer>("owning");
+    IocContainer& countingContainer = iocContainer.getRef<IocContainer>("counting");
+
+    bufferContainer.registerFactory<IRequest>(bufferFactory);
+    owningContainer.registerFactory<IRequest>(owningFactory);
+    countingContainer.registerDefaultFactory<IRequest, CountingRequest, CopyCounter>();
+
+    // Large arguments taken by const reference are never copied
+    vector<char> buffer(1 << 20, 'x');
+    const vector<char>& constBuffer = buffer;
+    auto& bufferRequest = downcast<BufferRequest>(
+        bufferContainer.createByName<IRequest>("lvalue", buffer).getRef<IRequest>("lvalue"));
+    BOOST_CHECK(bufferRequest.data == buffer.data());
+    auto constRequest = bufferContainer.createWithoutStoring<IRequest>(constBuffer);
+    BOOST_CHECK(downcast<BufferRequest>(*constRequest).data == buffer.data());
+
+    // Move-only arguments are moved all the way through, but must be passed as rvalues
+    auto owned = make_unique<vector<char>>(1 << 20, 'y');
+    const char* ownedData = owned->data();
+    BOOST_CHECK_THROW(auto request = owningContainer.createWithoutStoring<IRequest>(owned),
+                      IocException);
+    auto owningRequest = owningContainer.createWithoutStoringShared<IRequest>(move(owned));
+    BOOST_CHECK(!owned);
+    BOOST_CHECK(downcast<OwningRequest>(*owningRequest).buffer->data() == ownedData);
+
+    // Parameters taken by value are moved from rvalues and only copied from lvalues
+    int copies = 0;
+    int moves = 0;
+    CopyCounter counter(copies, moves);
+    countingContainer.create<IRequest>(move(counter));
+    BOOST_CHECK_EQUAL(copies, 0);
+    countingContainer.create<IRequest>(counter);
+    BOOST_CHECK_EQUAL(copies, 1);
+}
+
+BOOST_AUTO_TEST_CASE(testFactoryOverloads)
+{
+    class IViewport
+    {
+    public:
+        virtual ~IViewport()
+        {
+        }
+    };
+
+    class Viewport : public IViewport
+    {
+    public:
+        Viewport(int width = 640, int height = 480)
+            : width(width)
+            , height(height)
+        {
+        }
+
+        int width;
+        int height;
+    };
+
+    iocContainer.registerDefaultFactory<IViewport, Viewport>()
+        .registerDefaultFactory<IViewport, Viewport, int, int>()
+        .registerFactory<IViewport>(
+            [](const string& resolution) { return make_shared<Viewport>(1920, 1080); });
+
+    auto defaulted = iocContainer.createWithoutStoring<IViewport>();
+    auto sized = iocContainer.createWithoutStoring<IViewport>(800, 600);
+    auto named = iocContainer.createWithoutStoringShared<IViewport>(string("1080p"));
+
+    BOOST_CHECK_EQUAL(downcast<Viewport>(*defaulted).width, 640);
+    BOOST_CHECK_EQUAL(downcast<Viewport>(*sized).width, 800);
+    BOOST_CHECK_EQUAL(downcast<Viewport>(*named).width, 1920);
+
+    // The nullary overload is used to create instances on retrieval
+    BOOST_CHECK_EQUAL(downcast<Viewport>(iocContainer.getRef<IViewport>("a")).height, 480);
+
+    // Re-registering the same signature replaces the overload
+    iocContainer.registerFactory<IViewport>(
+        [](int width, int height) { return make_unique<Viewport>(width * 2, height * 2); });
+    auto doubled = iocContainer.createWithoutStoring<IViewport>(800, 600);
+    BOOST_CHECK_EQUAL(downcast<Viewport>(*doubled).width, 1600);
+
+    BOOST_CHECK_THROW(auto viewport = iocContainer.createWithoutStoring<IViewport>(1.0),
+                      IocException);
+}
+
+BOOST_AUTO_TEST_CASE(testNamedFactories)
+{
+    class IViewport
+    {
+    public:
+        virtual ~IViewport()
+        {
+        }
+
+        virtual string api() const = 0;
+    };
+
+    class Direct3DViewport : public IViewport
+    {
+    public:
+        string api() const override
+        {
+            return "Direct3D";
+        }
+    };
+
+    class OpenGlViewport : public IViewport
+    {
+    public:
+        string api() const override
+        {
+            return "OpenGL";
+        }
+    };
+
+    iocContainer.registerDefaultFactory<IViewport, Direct3DViewport>()
+        .registerDefaultFactory<IViewport, OpenGlViewport>("gl")
+        .registerFactory<IViewport>("gl.shared", []() { return make_shared<OpenGlViewport>(); });
+
+    // Named factories are preferred, but unknown names fall back to the unnamed factory
+    BOOST_CHECK_EQUAL(iocContainer.getRef<IViewport>("gl").api(), "OpenGL");
+    BOOST_CHECK_EQUAL(iocContainer.getRef<IViewport>("gl.shared").api(), "OpenGL");
+    BOOST_CHECK_EQUAL(iocContainer.getRef<IViewport>("d3d").api(), "Direct3D");
+    BOOST_CHECK_EQUAL(iocContainer.getRef<IViewport>().api(), "Direct3D");
+    BOOST_CHECK_EQUAL(iocContainer.createByNameWithoutStoring<IViewport>("gl")->api(), "OpenGL");
+    BOOST_CHECK_EQUAL(iocContainer.size(), 4);
+
+    // Child containers use the factories of their parent
+    auto& child = iocContainer.getRef<IocContainer>("child");
+    BOOST_CHECK_EQUAL(child.createByName<IViewport>("gl").getRef<IViewport>("gl").api(),
+                      "OpenGL");
+
+    // Named factories are only a fallback for the signature they were registered with
+    BOOST_CHECK_THROW(child.createByName<IViewport>("gl", 3), IocException);
+}
+
+BOOST_AUTO_TEST_CASE(testMemoizedFactory)
+{
+    struct Codec
+    {
+        Codec(string format, int bitrate)
+            : format(move(format))
+            , bitrate(bitrate)
+        {
+        }
+
+        string format;
+        int bitrate;
+    };
+
+    int constructed = 0;
+
+    iocContainer.registerMemoizedFactory<Codec, string, int>(
+        [&constructed](const string& format, int bitrate) {
+            ++constructed;
+            return make_shared<Codec>(format, bitrate);
+        },
+        2);
+
+    auto aac = iocContainer.createWithoutStoringShared<Codec>(string("aac"), 128);
+    BOOST_CHECK_EQUAL(aac->format, "aac");
+    BOOST_CHECK_EQUAL(aac->bitrate, 128);
+
+    // Repeated arguments return the cached instance
+    BOOST_CHECK_EQUAL(iocContainer.createWithoutStoringShared<Codec>(string("aac"), 128), aac);
+    BOOST_CHECK_EQUAL(iocContainer.create<Codec>(string("aac"), 128).getShared<Codec>(), aac);
+    BOOST_CHECK_EQUAL(constructed, 1);
+
+    auto opus = iocContainer.createWithoutStoringShared<Codec>(string("opus"), 64);
+    BOOST_CHECK_NE(opus, aac);
+    BOOST_CHECK_EQUAL(constructed, 2);
+
+    auto stats = iocContainer.memoizationStats<Codec, string, int>();
+    BOOST_CHECK_EQUAL(stats.hits, 2);
+    BOOST_CHECK_EQUAL(stats.misses, 2);
+    BOOST_CHECK_EQUAL(stats.evictions, 0);
+    BOOST_CHECK_EQUAL(stats.size, 2);
+
+    // Using aac makes opus the least recently used, so it is evicted once at capacity
+    BOOST_CHECK_EQUAL(iocContainer.createWithoutStoringShared<Codec>(string("aac"), 128), aac);
+    auto mp3 = iocContainer.createWithoutStoringShared<Codec>(string("mp3"), 320);
+    BOOST_CHECK_EQUAL(iocContainer.createWithoutStoringShared<Codec>(string("aac"), 128), aac);
+    BOOST_CHECK_NE(iocContainer.createWithoutStoringShared<Codec>(string("opus"), 64), opus);
+    BOOST_CHECK_EQUAL(constructed, 4);
+
+    stats = iocContainer.memoizationStats<Codec, string, int>();
+    BOOST_CHECK_EQUAL(stats.hits, 4);
+    BOOST_CHECK_EQUAL(stats.misses, 4);
+    BOOST_CHECK_EQUAL(stats.evictions, 2);
+    BOOST_CHECK_EQUAL(stats.size, 2);
+
+    // First in, first out doesn't refresh entries on a hit
+    iocContainer.registerMemoizedFactory<Codec, int>(
+        "fifo",
+        [](int bitrate) { return make_unique<Codec>("fifo", bitrate); },
+        1,
+        IocContainer::EvictionPolicy::FirstInFirstOut);
+
+    auto first = iocContainer.createByNameWithoutStoringShared<Codec>("fifo", 1);
+    BOOST_CHECK_EQUAL(iocContainer.createByNameWithoutStoringShared<Codec>("fifo", 1), first);
+    auto second = iocContainer.createByNameWithoutStoringShared<Codec>("fifo", 2);
+    BOOST_CHECK_NE(iocContainer.createByNameWithoutStoringShared<Codec>("fifo", 1), first);
+    stats = iocContainer.memoizationStats<Codec, int>("fifo");
+    BOOST_CHECK_EQUAL(stats.evictions, 2);
+
+    BOOST_CHECK_THROW(stats = iocContainer.memoizationStats<IocContainer>(), IocException);
+}
+
+BOOST_AUTO_TEST_CASE(testCreateMany)
+{
+    class IViewport
+    {
+    public:
+        virtual ~IViewport()
+        {
+        }
+
+        virtual int area() const = 0;
+    };
+
+    class Viewport : public IViewport
+    {
+    public:
+        Viewport(int width, int height)
+            : width(width)
+            , height(height)
+        {
+        }
+
+        int area() const override
+        {
+            return width * height;
+        }
+
+        int width;
+        int height;
+    };
+
+    iocContainer.registerDefaultFactory<IViewport, Viewport, int, int>().registerFactory<IViewport>(
+        "separate", [](int width, int height) { return make_unique<Viewport>(width, height); });
+
+    iocContainer.createMany<IViewport>(8, 4, 3).createManyByName<IViewport>("separate", 2, 5, 5);
+    BOOST_CHECK_EQUAL(iocContainer.size(), 2);
+
+    // Instances created from the default factory are contiguous
+    auto& viewports = iocContainer.getRef<InstanceGroup<IViewport>>();
+    BOOST_CHECK_EQUAL(viewports.size(), 8);
+
+    for (size_t index = 1; index < viewports.size(); ++index)
+    {
+        auto* previous = &downcast<Viewport>(viewports[index - 1]);
+        BOOST_CHECK_EQUAL(&downcast<Viewport>(viewports[index]), previous + 1);
+    }
+
+    int totalArea = 0;
+
+    for (const auto& viewport : viewports)
+    {
+        totalArea += viewport.area();
+    }
+
+    BOOST_CHECK_EQUAL(totalArea, 8 * 12);
+
+    // Other factories are invoked per instance
+    auto& separate = iocContainer.getRef<InstanceGroup<IViewport>>("separate");
+    BOOST_CHECK_EQUAL(separate.size(), 2);
+    BOOST_CHECK_EQUAL(separate[0].area(), 25);
+    BOOST_CHECK_EQUAL(separate[1].area(), 25);
+    BOOST_CHECK_NE(&separate[0], &separate[1]);
+
+    BOOST_CHECK_THROW(iocContainer.createMany<IViewport>(2, 3.0), IocException);
+}
+
+BOOST_AUTO_TEST_CASE(testIndexedInstances)
+{
+    int first = 1;
+    int second = 2;
+
+    iocContainer.bindIndexed(0, ref(first))
+        .bindIndexed(3, make_shared<int>(4))
+        .bindIndexed(1, &second)
+        .bindInstance("viewport0", make_shared<int>(10));
+    BOOST_CHECK_EQUAL(iocContainer.size(), 4);
+
+    BOOST_CHECK_EQUAL(&iocContainer.getRef<int>(0), &first);
+    BOOST_CHECK_EQUAL(iocContainer.getPtr<int>(1), &second);
+    BOOST_CHECK_EQUAL(iocContainer.get<int>(3), 4);
+    BOOST_CHECK_EQUAL(*iocContainer.getShared<int>(3), 4);
+
+    // Indexed instances are independent of the named ones
+    BOOST_CHECK_EQUAL(iocContainer.get<int>("viewport0"), 10);
+    BOOST_CHECK(iocContainer.contains<int>(1));
+    BOOST_CHECK(!iocContainer.contains<int>(2));
+    BOOST_CHECK(!iocContainer.contains<double>(0));
+    BOOST_CHECK_THROW(int& missing = iocContainer.getRef<int>(2), IocException);
+    BOOST_CHECK_THROW(double& missing = iocContainer.getRef<double>(0), IocException);
+
+    // Rebinding replaces the instance at that index
+    iocContainer.bindIndexed(1, make_unique<int>(5));
+    BOOST_CHECK_EQUAL(iocContainer.get<int>(1), 5);
+
+    iocContainer.eraseInstance<int>(3).eraseInstance<int>(0);
+    BOOST_CHECK_EQUAL(iocContainer.size(), 2);
+    BOOST_CHECK(!iocContainer.contains<int>(0));
+    BOOST_CHECK_EQUAL(iocContainer.get<int>(1), 5);
+}
+
+BOOST_AUTO_TEST_CASE(testHashedNames)
+{
+    static_assert("numHorizViewports"_ioc.hash() == NameKey::hashOf("numHorizViewports"));
+    static_assert(IOC_NAME("numVertViewports").hash() == NameKey::hashOf("numVertViewports"));
+
+    iocContainer.bindValue("numHorizViewports"_ioc, 4).bindValue(IOC_NAME("numVertViewports"), 3);
+
+    // Hashed names refer to the same instances as plain strings
+    BOOST_CHECK_EQUAL(iocContainer.get<int>("numHorizViewports"), 4);
+    BOOST_CHECK_EQUAL(iocContainer.getRef<int>(string("numVertViewports")), 3);
+    BOOST_CHECK_EQUAL(iocContainer.get<int>(IOC_NAME("numHorizViewports")), 4);
+    BOOST_CHECK(!iocContainer.contains<int>("numViewports"_ioc));
+
+    iocContainer.registerFactory<string>("greeting"_ioc,
+                                         []() { return make_unique<string>("hi"); });
+    iocContainer.createByName<string>("greeting"_ioc);
+    BOOST_CHECK_EQUAL(iocContainer.get<string>("greeting"), "hi");
+
+    // Names whose hashes collide are told apart by their strings
+    const auto collision = NameKey::hashOf("numHorizViewports");
+    iocContainer.bindValue(NameKey("colliding", collision), 5);
+    BOOST_CHECK_EQUAL(iocContainer.get<int>(NameKey("colliding", collision)), 5);
+    BOOST_CHECK_EQUAL(iocContainer.get<int>("numHorizViewports"_ioc), 4);
+
+    iocContainer.eraseInstance<int>("numHorizViewports"_ioc);
+    BOOST_CHECK_EQUAL(iocContainer.get<int>(NameKey("colliding", collision)), 5);
+    BOOST_CHECK(!iocContainer.contains<int>("numHorizViewports"));
+}
+
+BOOST_AUTO_TEST_CASE(testTaggedInstances)
+{
+    struct AuditTag
+    {
+    };
+
+    struct DebugTag
+    {
+    };
+
+    string untagged("untagged");
+    string debug("debug");
+
+    iocContainer.bindInstance(ref(untagged))
+        .bindInstance<string, AuditTag>(make_unique<string>("audit"))
+        .bindInstance<string, DebugTag>(&debug);
+    BOOST_CHECK_EQUAL(iocContainer.size(), 3);
+
+    BOOST_CHECK_EQUAL(iocContainer.get<string>(), "untagged");
+    BOOST_CHECK_EQUAL((iocContainer.get<string, AuditTag>()), "audit");
+    BOOST_CHECK_EQUAL((iocContainer.getPtr<string, DebugTag>()), &debug);
+    BOOST_CHECK_EQUAL((*iocContainer.getShared<string, AuditTag>()), "audit");
+
+    // Tags are distinct from names, and from the tags of other types
+    BOOST_CHECK((iocContainer.contains<string, AuditTag>()));
+    BOOST_CHECK((!iocContainer.contains<int, AuditTag>()));
+    BOOST_CHECK(!iocContainer.contains<string>("AuditTag"));
+    BOOST_CHECK_THROW(int& missing = (iocContainer.getRef<int, AuditTag>()), IocException);
+
+    iocContainer.bindInstance<string, AuditTag>(make_shared<string>("rebound"));
+    BOOST_CHECK_EQUAL((iocContainer.getRef<string, AuditTag>()), "rebound");
+
+    iocContainer.eraseInstance<string, AuditTag>();
+    BOOST_CHECK((!iocContainer.contains<string, AuditTag>()));
+    BOOST_CHECK_EQUAL(iocContainer.size(), 2);
+}
+
+BOOST_AUTO_TEST_CASE(testDenseTypeIndices)
+{
+    struct First
+    {
+    };
+
+    struct Second
+    {
+    };
+
+    const auto first = TypeKey::of<First>().index();
+    const auto second = TypeKey::of<Second>().index();
+
+    BOOST_CHECK_NE(first, second);
+    BOOST_CHECK_EQUAL(TypeKey::of<First>().index(), first);
+    BOOST_CHECK_EQUAL(TypeKey::of<const First&>().index(), first);
+
+    // Unnamed instances stay in place while instances of further types are bound
+    iocContainer.bindValue(42);
+    const int& value = iocContainer.getRef<int>();
+
+    iocContainer.bindValue(First()).bindValue(Second()).bindValue(1.5).bindValue('c');
+    BOOST_CHECK_EQUAL(&iocContainer.getRef<int>(), &value);
+    BOOST_CHECK_EQUAL(value, 42);
+    BOOST_CHECK_EQUAL(iocContainer.size(), 5);
+
+    iocContainer.eraseInstance<int>();
+    BOOST_CHECK(!iocContainer.contains<int>());
+    BOOST_CHECK_EQUAL(iocContainer.size(), 4);
+
+    // A child only holds the types it binds itself, however many types exist
+    auto& child = iocContainer.getRef<IocContainer>("child");
+    child.bindValue(short(7)).bindValue(2.5f).bindValue(3L).bindValue(4U).bindValue(5UL);
+    child.bindValue(6LL).bindValue(7ULL).bindValue(true).bindValue(string("eight"));
+    BOOST_CHECK_EQUAL(child.size(), 9);
+    BOOST_CHECK_EQUAL(child.get<short>(), 7);
+    BOOST_CHECK_EQUAL(child.get<string>(), "eight");
+
+    iocContainer.bindValue(43);
+    BOOST_CHECK_EQUAL(iocContainer.get<int>(), 43);
+    BOOST_CHECK_EQUAL(iocContainer.size(), 6);
+}
+
+BOOST_AUTO_TEST_CASE(testFactoryMissesAcrossParents)
+{
+    auto& child = iocContainer.getRef<IocContainer>();
+    auto& grandchild = child.getRef<IocContainer>();
+
+    // Repeated misses are answered from the cache
+    BOOST_CHECK_THROW(grandchild.create<string>(), IocException);
+    BOOST_CHECK_THROW(grandchild.create<string>(), IocException);
+    BOOST_CHECK_THROW(child.create<string>(), IocException);
+
+    // Registering a factory anywhere in the chain invalidates the misses
+    iocContainer.registerFactory<string>([]() { return make_unique<string>("from parent"); });
+    grandchild.create<string>();
+    BOOST_CHECK_EQUAL(grandchild.get<string>(), "from parent");
+
+    // Creating containers and registering factories outside of the chain leaves it alone
+    auto& sibling = iocContainer.getRef<IocContainer>("sibling");
+    sibling.registerFactory<int>([]() { return make_unique<int>(3); });
+    static_cast<void>(sibling.getRef<IocContainer>());
+    BOOST_CHECK_THROW(grandchild.create<int>(), IocException);
+    BOOST_CHECK(grandchild.tryCreate<int>() == ErrorCode::NoFactory);
+
+    child.registerFactory<int>([]() { return make_unique<int>(7); });
+    grandchild.create<int>();
+    BOOST_CHECK_EQUAL(grandchild.get<int>(), 7);
+}
+
+BOOST_AUTO_TEST_CASE(testErrorCodes)
+{
+    struct AuditTag
+    {
+    };
+
+    // Failures are returned, rather than thrown
+    BOOST_CHECK(iocContainer.tryGetPtr<int>().error() == ErrorCode::NotFound);
+    BOOST_CHECK(iocContainer.tryGetShared<int>("width").error() == ErrorCode::NotFound);
+    BOOST_CHECK(iocContainer.tryGetPtr<int>(0).error() == ErrorCode::NotFound);
+    BOOST_CHECK((iocContainer.tryGetShared<int, AuditTag>().error() == ErrorCode::NotFound));
+    BOOST_CHECK(iocContainer.tryCreate<string>() == ErrorCode::NoFactory);
+
+    iocContainer.registerFactory<string>([](int count) { return make_unique<string>(count, 'x'); });
+    BOOST_CHECK(iocContainer.tryCreate<string>() == ErrorCode::UnknownSignature);
+    BOOST_CHECK(iocContainer.tryGetPtr<string>().error() == ErrorCode::UnknownSignature);
+    BOOST_CHECK(iocContainer.tryCreateByName<string>("three", 3) == ErrorCode::None);
+
+    auto created = iocContainer.tryGetPtr<string>("three");
+    BOOST_REQUIRE(created);
+    BOOST_CHECK_EQUAL(**created, "xxx");
+
+    iocContainer.bindValue(5).bindIndexed(2, make_shared<int>(6));
+    BOOST_CHECK_EQUAL(*iocContainer.tryGetShared<int>().value(), 5);
+    BOOST_CHECK_EQUAL(*iocContainer.tryGetPtr<int>(2).value(), 6);
+
+    int fallback = 7;
+    BOOST_CHECK_EQUAL(iocContainer.tryGetPtr<int>("missing").valueOr(&fallback), &fallback);
+
+    // Arguments which can't be passed as the parameters of the factory are errors too
+    iocContainer.registerFactory<vector<int>>([](unique_ptr<int>&& first) {
+        return make_unique<vector<int>>(1, *first);
+    });
+
+    auto first = make_unique<int>(8);
+    BOOST_CHECK(iocContainer.tryCreate<vector<int>>(first) == ErrorCode::InvalidArgument);
+    BOOST_CHECK(iocContainer.tryCreateWithoutStoring<vector<int>>(first).error() ==
+                ErrorCode::InvalidArgument);
+    BOOST_CHECK_EQUAL(iocContainer.tryCreateWithoutStoringShared<vector<int>>(std::move(first))
+                          .value()
+                          ->front(),
+                      8);
+    BOOST_CHECK(iocContainer.tryCreateWithoutStoring<double>().error() == ErrorCode::NoFactory);
+
+    // The methods for aliases, swapping, borrowing, lifetimes and memoization have error
+    // returning variants too
+    BOOST_CHECK(iocContainer.tryAlias<double>("ratio", "") == ErrorCode::NotFound);
+    BOOST_CHECK(iocContainer.tryAlias<string>("copy", "three") == ErrorCode::None);
+    BOOST_CHECK_EQUAL(*iocContainer.tryGetPtr<string>("copy").value(), "xxx");
+    BOOST_CHECK(iocContainer.tryGetSwappable<string>().error() == ErrorCode::NotFound);
+    iocContainer.swap(make_shared<string>("swapped"));
+    BOOST_CHECK_EQUAL(*iocContainer.tryGetSwappable<string>().value()->load(), "swapped");
+
+    BOOST_CHECK(iocContainer.tryBorrow<string>("three").error() == ErrorCode::InvalidArgument);
+    BOOST_CHECK_EQUAL(*iocContainer.tryLend<string>("three").value()->borrow(), "xxx");
+    BOOST_CHECK(iocContainer.tryLend<string>("none").error() == ErrorCode::UnknownSignature);
+    iocContainer.setReclamation(IocContainer::Reclamation::Deferred);
+    BOOST_CHECK_EQUAL(*iocContainer.tryBorrow<string>("three").value(), "xxx");
+    BOOST_CHECK(iocContainer.tryBorrow<vector<char>>().error() == ErrorCode::NotFound);
+
+    BOOST_CHECK(iocContainer.tryGetReplicas<string>().error() == ErrorCode::NotFound);
+    BOOST_CHECK(iocContainer.tryGetThreadLocal<string>().error() == ErrorCode::NotFound);
+    BOOST_CHECK(iocContainer.tryForEachReplica<string>([](string&) {}) == ErrorCode::NotFound);
+    iocContainer.registerFactory<vector<int>>("counts", [] { return make_unique<vector<int>>(); },
+                                              IocContainer::Lifetime::PerCore);
+    BOOST_CHECK(iocContainer.tryForEachReplica<vector<int>>("counts", [](vector<int>&) {}) ==
+                ErrorCode::None);
+    BOOST_CHECK(iocContainer.tryGetReplicas<vector<int>>("counts"));
+
+    BOOST_CHECK(iocContainer.tryMemoizationStats<string>().error() ==
+                ErrorCode::UnknownSignature);
+    BOOST_CHECK((iocContainer.tryMemoizationStats<string, int>().error() ==
+                 ErrorCode::NotMemoized));
+    BOOST_CHECK((iocContainer.tryMemoizationStats<double, int>().error() ==
+                 ErrorCode::NoFactory));
+
+    // The throwing methods report the same error codes
+    auto missing = iocContainer.tryGetPtr<double>();
+    BOOST_CHECK_THROW(double* value = missing.value(), IocException);
+
+    try
+    {
+        iocContainer.create<string>();
+        BOOST_FAIL("Expected an exception");
+    }
+    catch (const IocException& ex)
+    {
+        BOOST_CHECK(ex.code() == ErrorCode::UnknownSignature);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(testImplements)
+{
+    struct IFly
+    {
+        virtual ~IFly() = default;
+        virtual int fly() const = 0;
+    };
+
+    struct IQuack
+    {
+        virtual ~IQuack() = default;
+        virtual int quack() const = 0;
+    };
+
+    struct Duck : public IFly, public IQuack
+    {
+        explicit Duck(int p_x)
+            : x(p_x)
+        {
+        }
+
+        int fly() const override
+        {
+            return x;
+        }
+
+        int quack() const override
+        {
+            return x * 2;
+        }
+
+        int x;
+    };
+
+    Duck mallard{1};
+
+    iocContainer.bindInstance(ref(mallard), implements<IFly, IQuack>())
+        .bindInstance("teal", make_shared<Duck>(2), implements<IQuack>());
+
+    BOOST_CHECK(iocContainer.contains<Duck>());
+    BOOST_CHECK(iocContainer.contains<IFly>());
+    BOOST_CHECK(iocContainer.contains<IQuack>());
+    BOOST_CHECK(!iocContainer.contains<IFly>("teal"));
+
+    // Each interface refers to the same instance, with its pointer adjusted to the base
+    BOOST_CHECK_EQUAL(&iocContainer.getRef<Duck>(), &mallard);
+    BOOST_CHECK_EQUAL(&iocContainer.getRef<IFly>(), static_cast<IFly*>(&mallard));
+    BOOST_CHECK_EQUAL(&iocContainer.getRef<IQuack>(), static_cast<IQuack*>(&mallard));
+    BOOST_CHECK_EQUAL(iocContainer.getRef<IQuack>("teal").quack(), 4);
+
+    // Shared pointers to an interface keep the instance alive
+    weak_ptr<IQuack> teal = iocContainer.getShared<IQuack>("teal");
+    {
+        auto shared = iocContainer.getShared<IQuack>("teal");
+        iocContainer.eraseInstance<Duck>("teal").eraseInstance<IQuack>("teal");
+        BOOST_CHECK(!teal.expired());
+        BOOST_CHECK_EQUAL(shared->quack(), 4);
+    }
+    BOOST_CHECK(teal.expired());
+
+    // Rebinding the instance replaces it for every interface
+    Duck pintail{3};
+    iocContainer.bindInstance(ref(pintail));
+    BOOST_CHECK_EQUAL(iocContainer.getRef<IFly>().fly(), 3);
+    BOOST_CHECK_EQUAL(iocContainer.getRef<IQuack>().quack(), 6);
+
+    // Whereas rebinding an interface replaces just that interface
+    Duck eider{4};
+    iocContainer.bindInstance<IFly>(ref(eider));
+    BOOST_CHECK_EQUAL(iocContainer.getRef<IFly>().fly(), 4);
+    BOOST_CHECK_EQUAL(iocContainer.getRef<IQuack>().quack(), 6);
+}
+
+BOOST_AUTO_TEST_CASE(testAliases)
+{
+    iocContainer.bindValue<string>("config.path", "/etc/app")
+        .alias<string>("configPath", "config.path")
+        .alias<string>("legacyPath", "configPath");
+
+    // Every alias refers to the same instance
+    BOOST_CHECK_EQUAL(iocContainer.getRef<string>("legacyPath"), "/etc/app");
+    BOOST_CHECK_EQUAL(&iocContainer.getRef<string>("configPath"),
+                      &iocContainer.getRef<string>("config.path"));
+    BOOST_CHECK_EQUAL(&iocContainer.getRef<string>("legacyPath"),
+                      &iocContainer.getRef<string>("config.path"));
+
+    // Rebinding under any of the names replaces the instance for all of them
+    iocContainer.bindValue<string>("config.path", "/opt/app");
+    BOOST_CHECK_EQUAL(iocContainer.getRef<string>("configPath"), "/opt/app");
+    iocContainer.bindInstance("legacyPath", make_shared<string>("/srv/app"));
+    BOOST_CHECK_EQUAL(iocContainer.getRef<string>("config.path"), "/srv/app");
+
+    // Inline values can be aliased too, including unnamed instances
+    iocContainer.bindValue(5).alias<int>("count", "");
+    iocContainer.bindValue(6);
+    BOOST_CHECK_EQUAL(iocContainer.get<int>("count"), 6);
+
+    // Sharing an aliased inline value copies it, so rebinding doesn't change the copy
+    auto count = iocContainer.getShared<int>("count");
+    BOOST_CHECK_EQUAL(count.use_count(), 1);
+    iocContainer.bindValue(7);
+    BOOST_CHECK_EQUAL(*count, 6);
+    iocContainer.bindInstance(make_shared<int>(42));
+    BOOST_CHECK_EQUAL(*count, 6);
+    BOOST_CHECK_EQUAL(*iocContainer.getShared<int>("count"), 42);
+
+    // Erasing a name leaves the others intact
+    iocContainer.eraseInstance<string>("config.path");
+    BOOST_CHECK(!iocContainer.contains<string>("config.path"));
+    BOOST_CHECK_EQUAL(iocContainer.getRef<string>("configPath"), "/srv/app");
+
+    BOOST_CHECK_THROW(iocContainer.alias<string>("other", "config.path"), IocException);
+}
+
+BOOST_AUTO_TEST_CASE(testDeferredReclamation)
+{
+    struct Flusher
+    {
+        explicit Flusher(int& p_flushes)
+            : flushes(p_flushes)
+        {
+        }
+
+        ~Flusher()
+        {
+            ++flushes;
+        }
+
+        int& flushes;
+    };
+
+    int flushes = 0;
+
+    iocContainer.setReclamation(IocContainer::Reclamation::Deferred);
+    iocContainer.emplace<Flusher>("log", flushes).emplace<Flusher>("audit", flushes);
+    iocContainer.bindIndexed(0, make_shared<Flusher>(flushes));
+
+    // Erased and replaced instances are kept until they are reclaimed
+    iocContainer.eraseInstance<Flusher>("log")
+        .emplace<Flusher>("audit", flushes)
+        .eraseInstance<Flusher>(0);
+    BOOST_CHECK(!iocContainer.contains<Flusher>("log"));
+    BOOST_CHECK_EQUAL(flushes, 0);
+
+    BOOST_CHECK_EQUAL(iocContainer.reclaim(), 3);
+    BOOST_CHECK_EQUAL(flushes, 3);
+    BOOST_CHECK_EQUAL(iocContainer.reclaim(), 0);
+
+    // Reclaiming can happen on another thread
+    iocContainer.eraseInstance<Flusher>("audit");
+    thread([&] { BOOST_CHECK_EQUAL(iocContainer.reclaim(), 1); }).join();
+    BOOST_CHECK_EQUAL(flushes, 4);
+
+    iocContainer.setReclamation(IocContainer::Reclamation::Immediate);
+    iocContainer.emplace<Flusher>("log", flushes).eraseInstance<Flusher>("log");
+    BOOST_CHECK_EQUAL(flushes, 5);
+}
+
+BOOST_AUTO_TEST_CASE(testShutdownPolicy)
+{
+    struct Service
+    {
+        Service(vector<string>& p_released, string p_name)
+            : released(p_released)
+            , name(std::move(p_name))
+        {
+        }
+
+        ~Service()
+        {
+            released.push_back(name);
+        }
+
+        vector<string>& released;
+        string name;
+    };
+
+    vector<string> released;
+
+    {
+        IocContainer container;
+        container.emplace<Service>("unordered", released, "unordered");
+        container.setShutdownPolicy(IocContainer::ShutdownPolicy::DependencyOrdered);
+
+        container.emplace<Service>("database", released, "database")
+            .bindIndexed(0, make_shared<Service>(released, "cache"))
+            .emplace<Service>("server", released, "server")
+            .emplace<Service>("erased", released, "erased")
+            .eraseInstance<Service>("erased");
+
+        // Sub-containers are shut down the same way
+        auto& child = container.getRef<IocContainer>();
+        BOOST_CHECK(child.shutdownPolicy() == IocContainer::ShutdownPolicy::DependencyOrdered);
+    }
+
+    // Instances bound before the policy was set are released first
+    const vector<string> expected{"erased", "unordered", "server", "cache", "database"};
+    BOOST_CHECK_EQUAL_COLLECTIONS(
+        released.begin(), released.end(), expected.begin(), expected.end());
+
+    released.clear();
+
+    {
+        IocContainer container;
+        container.setShutdownPolicy(IocContainer::ShutdownPolicy::LeakOnExit);
+        container.emplace<Service>("leaked", released, "leaked");
+    }
+
+    BOOST_CHECK(released.empty());
+}
+
+BOOST_AUTO_TEST_CASE(testSwap)
+{
+    struct RoutingTable
+    {
+        explicit RoutingTable(int p_version)
+            : version(p_version)
+        {
+        }
+
+        int version;
+    };
+
+    // Swapping replaces an instance that is already bound
+    iocContainer.bindInstance("routes", make_shared<RoutingTable>(-1));
+    iocContainer.swap("routes", make_shared<RoutingTable>(0));
+    BOOST_CHECK_EQUAL(iocContainer.getShared<RoutingTable>("routes")->version, 0);
+
+    auto routes = iocContainer.getSwappable<RoutingTable>("routes");
+
+    // Readers keep the instance they loaded, while new readers see the replacement
+    auto loaded = routes->load();
+    iocContainer.swap("routes", make_shared<RoutingTable>(1));
+    BOOST_CHECK_EQUAL(loaded->version, 0);
+    BOOST_CHECK_EQUAL(routes->load()->version, 1);
+    BOOST_CHECK_EQUAL(iocContainer.getSwappable<RoutingTable>("routes")->load()->version, 1);
+    BOOST_CHECK_EQUAL(iocContainer.getRef<RoutingTable>("routes").version, 1);
+    BOOST_CHECK_EQUAL(iocContainer.size(), 2);
+
+    // Readers only ever see complete instances, which never go backwards
+    atomic<bool> done{false};
+    atomic<bool> monotonic{true};
+    thread reader([&] {
+        int last = 0;
+
+        while (!done)
+        {
+            const int version = routes->load()->version;
+            monotonic = monotonic && version >= last;
+            last = version;
+        }
+    });
+
+    for (int version = 2; version < 1000; ++version)
+    {
+        iocContainer.swap("routes", make_shared<RoutingTable>(version));
+    }
+
+    done = true;
+    reader.join();
+    BOOST_CHECK(monotonic);
+    BOOST_CHECK_EQUAL(routes->load()->version, 999);
+
+    BOOST_CHECK_THROW(auto missing = iocContainer.getSwappable<RoutingTable>(), IocException);
+}
+
+BOOST_AUTO_TEST_CASE(testBorrow)
+{
+    struct Service
+    {
+        explicit Service(atomic<bool>& p_released)
+            : released(p_released)
+        {
+        }
+
+        ~Service()
+        {
+            released = true;
+        }
+
+        int calls{0};
+        atomic<bool>& released;
+    };
+
+    atomic<bool> released{false};
+
+    // Without deferred reclamation, nothing would keep a borrowed instance alive
+    iocContainer.emplace<Service>("service", released);
+    BOOST_CHECK_THROW(auto immediate = iocContainer.borrow<Service>("service"), IocException);
+
+    iocContainer.setReclamation(IocContainer::Reclamation::Deferred);
+
+    // Borrowing doesn't take a reference to the instance, so it is only referenced by the
+    // container, and the shared_ptr used to check it
+    auto service = iocContainer.borrow<Service>("service");
+    ++service->calls;
+    BOOST_CHECK_EQUAL(&*service, iocContainer.getPtr<Service>("service"));
+    BOOST_CHECK_EQUAL(iocContainer.getShared<Service>("service").use_count(), 2);
+
+    // Reclaiming waits for the borrowed instance, which remains valid after it is erased
+    iocContainer.eraseInstance<Service>("service");
+    thread reclaimer([&] { iocContainer.reclaim(); });
+
+    this_thread::sleep_for(chrono::milliseconds(20));
+    BOOST_CHECK(!released);
+    BOOST_CHECK_EQUAL(service->calls, 1);
+
+    {
+        auto moved = std::move(service);
+    }
+
+    reclaimer.join();
+    BOOST_CHECK(released);
+
+    // Switching back to immediate reclamation waits for the borrowed references
+    iocContainer.emplace<Service>("service", released);
+    auto borrowed = iocContainer.borrow<Service>("service");
+
+    atomic<bool> switched{false};
+    thread switcher([&] {
+        iocContainer.setReclamation(IocContainer::Reclamation::Immediate);
+        switched = true;
+    });
+
+    this_thread::sleep_for(chrono::milliseconds(20));
+    BOOST_CHECK(!switched);
+
+    {
+        auto moved = std::move(borrowed);
+    }
+
+    switcher.join();
+    BOOST_CHECK_THROW(auto again = iocContainer.borrow<Service>("service"), IocException);
+
+    // A lender resolves the instance once, and keeps it alive, so it can be borrowed from
+    // without deferred reclamation
+    released = false;
+    auto lender = iocContainer.lend<Service>("service");
+    iocContainer.eraseInstance<Service>("service");
+    BOOST_CHECK(!released);
+
+    // Borrowing from the lender doesn't lock the container, so it completes while another
+    // thread holds the lock
+    promise<void> locked;
+    promise<void> unlock;
+    auto unlocked = unlock.get_future().share();
+    thread locker([&] {
+        iocContainer.emplace<LockHolder>("locker", locked, unlocked);
+    });
+
+    locked.get_future().wait();
+    auto borrowing = async(launch::async, [&] {
+        auto borrowedService = lender->borrow();
+        return ++borrowedService->calls;
+    });
+
+    BOOST_CHECK(borrowing.wait_for(chrono::seconds(5)) == future_status::ready);
+    unlock.set_value();
+    locker.join();
+    BOOST_CHECK_EQUAL(borrowing.get(), 1);
+
+    // Destroying the lender waits for its borrowed references, before releasing the instance
+    auto lent = lender->borrow();
+    thread destroyer([&] { lender.reset(); });
+
+    this_thread::sleep_for(chrono::milliseconds(20));
+    BOOST_CHECK(!released);
+    BOOST_CHECK_EQUAL(lent->calls, 1);
+
+    {
+        auto moved = std::move(lent);
+    }
+
+    destroyer.join();
+    BOOST_CHECK(released);
+}
+
+BOOST_AUTO_TEST_CASE(testPerThreadLifetime)
+{
+    struct ScratchBuffer
+    {
+        explicit ScratchBuffer(atomic<int>& p_live)
+            : live(p_live)
+        {
+            ++live;
+        }
+
+        ~ScratchBuffer()
+        {
+            --live;
+        }
+
+        vector<char> data;
+        atomic<int>& live;
+    };
+
+    atomic<int> live{0};
+
+    iocContainer.registerFactory<ScratchBuffer>(
+        [&] { return make_unique<ScratchBuffer>(live); }, IocContainer::Lifetime::PerThread);
+
+    // Each thread gets its own instance, which is created lazily
+    BOOST_CHECK_EQUAL(live, 0);
+    auto* mainBuffer = &iocContainer.getRef<ScratchBuffer>();
+    BOOST_CHECK_EQUAL(mainBuffer, &iocContainer.getRef<ScratchBuffer>());
+    BOOST_CHECK_EQUAL(live, 1);
+
+    ScratchBuffer* otherBuffer = nullptr;
+    thread([&] {
+        otherBuffer = &iocContainer.getRef<ScratchBuffer>();
+        mainBuffer->data.push_back(iocContainer.getPtr<ScratchBuffer>() == otherBuffer);
+    }).join();
+
+    BOOST_CHECK(otherBuffer != mainBuffer);
+    BOOST_CHECK_EQUAL(mainBuffer->data.size(), 1);
+    BOOST_CHECK_EQUAL(mainBuffer->data[0], true);
+
+    // The instance of the other thread was released when it exited
+    BOOST_CHECK_EQUAL(live, 1);
+
+    // Threads can hold on to the instances, and find their own without locking the
+    // container, so they find it while another thread holds the lock
+    auto buffers = iocContainer.getThreadLocal<ScratchBuffer>();
+    BOOST_CHECK_EQUAL(&buffers->local(), mainBuffer);
+
+    promise<void> locked;
+    promise<void> unlock;
+    auto unlocked = unlock.get_future().share();
+    thread locker([&] {
+        iocContainer.emplace<LockHolder>("locker", locked, unlocked);
+    });
+
+    locked.get_future().wait();
+    auto resolving = async(launch::async, [&] { return &buffers->local(); });
+
+    BOOST_CHECK(resolving.wait_for(chrono::seconds(5)) == future_status::ready);
+    BOOST_CHECK_EQUAL(&buffers->local(), mainBuffer);
+    unlock.set_value();
+    locker.join();
+    BOOST_CHECK(resolving.get() != mainBuffer);
+    BOOST_CHECK_EQUAL(live, 1);
+    buffers.reset();
+
+    BOOST_CHECK_THROW(auto none = iocContainer.getThreadLocal<string>(), IocException);
+
+    // The factory remains available to create instances explicitly
+    auto created = iocContainer.createByNameWithoutStoringShared<ScratchBuffer>("");
+    BOOST_CHECK(created.get() != mainBuffer);
+    BOOST_CHECK_EQUAL(&iocContainer.getRef<ScratchBuffer>(), mainBuffer);
+
+    // Erasing the binding releases the instances of the threads which are still running
+    created.reset();
+    iocContainer.eraseInstance<ScratchBuffer>();
+    BOOST_CHECK_EQUAL(live, 0);
+
+    // The entries a thread keeps for erased bindings are dropped as it resolves new ones
+    for (int i = 0; i < 100; ++i)
+    {
+        iocContainer.registerFactory<ScratchBuffer>(
+            [&] { return make_unique<ScratchBuffer>(live); }, IocContainer::Lifetime::PerThread);
+        BOOST_CHECK(iocContainer.getRef<ScratchBuffer>().data.empty());
+        iocContainer.eraseInstance<ScratchBuffer>();
+    }
+
+    BOOST_CHECK_EQUAL(live, 0);
+}
+
+BOOST_AUTO_TEST_CASE(testPerCoreLifetime)
+{
+    struct Counter
+    {
+        atomic<int> value{0};
+    };
+
+    // Counters returned by value are constructed in place, on cache lines of their own
+    iocContainer.registerFactory<Counter>([] { return Counter(); },
+                                          IocContainer::Lifetime::PerCore);
+    BOOST_CHECK_EQUAL(reinterpret_cast<uintptr_t>(&iocContainer.getRef<Counter>()) % 64, 0);
+
+    // Threads can hold on to the replicas, and find their counter without locking the
+    // container
+    auto replicas = iocContainer.getReplicas<Counter>();
+    vector<thread> threads;
+
+    for (int i = 0; i < 4; ++i)
+    {
+        threads.emplace_back([&, i] {
+            for (int j = 0; j < 1000; ++j)
+            {
+                ++(i % 2 ? replicas->local() : iocContainer.getRef<Counter>()).value;
+            }
+        });
+    }
+
+    for (auto& thread : threads)
+    {
+        thread.join();
+    }
+
+    // The aggregate visits each of the instances which were created
+    int total = 0;
+    size_t instances = 0;
+    iocContainer.forEachReplica<Counter>([&](Counter& counter) {
+        total += counter.value;
+        ++instances;
+    });
+
+    BOOST_CHECK_EQUAL(total, 4000);
+    BOOST_CHECK(instances >= 1 && instances <= max(thread::hardware_concurrency(), 1u));
+
+    iocContainer.bindValue(5);
+    BOOST_CHECK_THROW(iocContainer.forEachReplica<int>([](int&) {}), IocException);
+
+    // Instances the factory allocates are moved into place, if they can be
+    iocContainer.registerFactory<string>([] { return make_unique<string>("counter"); },
+                                         IocContainer::Lifetime::PerCore);
+    BOOST_CHECK_EQUAL(reinterpret_cast<uintptr_t>(&iocContainer.getRef<string>()) % 64, 0);
+    BOOST_CHECK_EQUAL(iocContainer.getReplicas<string>()->local(), "counter");
+    BOOST_CHECK_EQUAL(*iocContainer.createWithoutStoring<string>(), "counter");
+
+    // Instances the factory shares are left with their other owners, rather than moved from
+    auto shared = make_shared<string>("shared");
+    iocContainer.registerFactory<string>("shared", [shared] { return shared; },
+                                         IocContainer::Lifetime::PerCore);
+    BOOST_CHECK_EQUAL(&iocContainer.getRef<string>("shared"), shared.get());
+    BOOST_CHECK_EQUAL(*shared, "shared");
+
+    // Polymorphic instances may be derived from T, so they aren't sliced into place
+    struct Shape
+    {
+        virtual ~Shape() = default;
+
+        virtual int sides() const
+        {
+            return 0;
+        }
+    };
+
+    struct Square : public Shape
+    {
+        int sides() const override
+        {
+            return 4;
+        }
+    };
+
+    iocContainer.registerFactory<Shape>([] { return unique_ptr<Shape>(make_unique<Square>()); },
+                                        IocContainer::Lifetime::PerCore);
+    BOOST_CHECK_EQUAL(iocContainer.getRef<Shape>().sides(), 4);
+}
+
+BOOST_AUTO_TEST_CASE(testPerNumaNodeLifetime)
+{
+    // Simulates a machine with two nodes, where threads are on the node they were pinned to
+    struct SimulatedTopology : public NumaTopology
+    {
+        size_t nodeCount() const override
+        {
+            return 2;
+        }
+
+        size_t currentNode() const override
+        {
+            return node();
+        }
+
+        void pinToNode(size_t p_node) const override
+        {
+            node() = p_node;
+        }
+
+        static size_t& node()
+        {
+            static thread_local size_t node = 0;
+
+            return node;
+        }
+    };
+
+    struct LookupTable
+    {
+        size_t node{0};
+        thread::id creator;
+    };
+
+    auto topology = make_shared<SimulatedTopology>();
+    iocContainer.setNumaTopology(topology);
+    iocContainer.registerFactory<LookupTable>(
+        [&] {
+            auto table = make_unique<LookupTable>();
+            table->node = topology->currentNode();
+            table->creator = this_thread::get_id();
+            return table;
+        },
+        IocContainer::Lifetime::PerNumaNode);
+
+    // Each node gets its replica, which is created on a thread pinned to that node
+    auto& local = iocContainer.getRef<LookupTable>();
+    BOOST_CHECK_EQUAL(local.node, 0);
+    BOOST_CHECK(local.creator != this_thread::get_id());
+    BOOST_CHECK_EQUAL(&local, &iocContainer.getRef<LookupTable>());
+
+    LookupTable* remote = nullptr;
+    thread([&] {
+        topology->pinToNode(1);
+        remote = &iocContainer.getRef<LookupTable>();
+    }).join();
+
+    BOOST_REQUIRE(remote != nullptr);
+    BOOST_CHECK(remote != &local);
+    BOOST_CHECK_EQUAL(remote->node, 1);
+
+    size_t replicas = 0;
+    iocContainer.forEachReplica<LookupTable>([&](LookupTable&) { ++replicas; });
+    BOOST_CHECK_EQUAL(replicas, 2);
+
+    // The topology of the machine always has at least one node
+    auto system = NumaTopology::system();
+    BOOST_CHECK(system->nodeCount() >= 1);
+    BOOST_CHECK(system->currentNode() < system->nodeCount());
+}
+
 //----------------------------------------------------------------------------------------------------------------------
 BOOST_AUTO_TEST_SUITE_END()
 //----------------------------------------------------------------------------------------------------------------------
@@ -0,0 +1,60 @@
+// Exercises the container through the C++20 module rather than the header, which checks
+// that everything needed to bind and retrieve instances is exported. This is a standalone
+// program, which returns non-zero if any of the checks fail
+#include <cstdio>
+#include <cstdlib>
+#include <functional>
+#include <memory>
+#include <string>
+
+import cppinvert;
+
+using namespace cppinvert;
+using namespace cppinvert::literals;
+using namespace std;
+
+static int failures = 0;
+
+#define CHECK(condition)                                                                           \
+    if (!(condition))                                                                              \
+    {                                                                                              \
+        std::fprintf(stderr, "%s(%d): check failed: %s\n", __FILE__, __LINE__, #condition);       \
+        ++failures;                                                                                \
+    }
+
+int main()
+{
+    IocContainer iocContainer;
+
+    string title = "viewports";
+    int width = 640;
+    int height = 480;
+    unique_ptr<double> scale(new double(1.5));
+
+    iocContainer.bindValue("title"_ioc, val(title))
+        .bindValue("moved", mval(scale))
+        .bindInstance("width", std::ref(width))
+        .bindInstance("height", shared_ptr<int>(&height, nullDeleter_v<int>));
+
+    CHECK(iocContainer.get<string>("title") == "viewports");
+    CHECK(*iocContainer.getRef<unique_ptr<double>>("moved") == 1.5);
+    CHECK(&iocContainer.getRef<int>("width") == &width);
+    CHECK(iocContainer.get<int>("height") == 480);
+    CHECK(iocContainer.tryGetPtr<int>().error() == ErrorCode::NotFound);
+
+    iocContainer.registerFactory<string>([](int count) { return make_unique<string>(count, 'x'); });
+    CHECK(iocContainer.tryCreateByName<string>("three", 3) == ErrorCode::None);
+    CHECK(iocContainer.get<string>("three") == "xxx");
+
+    try
+    {
+        static_cast<void>(iocContainer.getRef<float>());
+        CHECK(!"Expected an exception");
+    }
+    catch (const IocException& ex)
+    {
+        CHECK(ex.code() == ErrorCode::NotFound);
+    }
+
+    return failures == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,85 @@
+// Exercises the container when built without exceptions. Boost.Test requires exceptions,
+// so this is a standalone program, which returns non-zero if any of the checks fail
+#include <cppinvert/IocContainer.hpp>
+
+#include <cstdio>
+#include <cstdlib>
+#include <memory>
+#include <string>
+
+#include <boost/version.hpp>
+
+namespace boost
+{
+
+// Boost reports its own errors through these when built without exceptions
+void throw_exception(const std::exception& ex)
+{
+    std::fprintf(stderr, "%s\n", ex.what());
+    std::abort();
+}
+
+#if BOOST_VERSION >= 107300
+void throw_exception(const std::exception& ex, const boost::source_location&)
+{
+    throw_exception(ex);
+}
+#endif
+
+} // boost
+
+using namespace cppinvert;
+using namespace std;
+
+static int failures = 0;
+
+#define CHECK(condition)                                                                           \
+    if (!(condition))                                                                              \
+    {                                                                                              \
+        std::fprintf(stderr, "%s(%d): check failed: %s\n", __FILE__, __LINE__, #condition);       \
+        ++failures;                                                                                \
+    }
+
+int main()
+{
+    IocContainer iocContainer;
+
+    CHECK(iocContainer.tryGetPtr<int>().error() == ErrorCode::NotFound);
+    CHECK(iocContainer.tryCreate<string>() == ErrorCode::NoFactory);
+
+    iocContainer.registerFactory<string>([](int count) { return make_unique<string>(count, 'x'); });
+    CHECK(iocContainer.tryCreate<string>() == ErrorCode::UnknownSignature);
+    CHECK(iocContainer.tryCreateByName<string>("three", 3) == ErrorCode::None);
+
+    auto created = iocContainer.tryGetShared<string>("three");
+    CHECK(created && **created == "xxx");
+
+    iocContainer.bindValue(5);
+    CHECK(iocContainer.tryGetPtr<int>() && *iocContainer.tryGetPtr<int>().value() == 5);
+    CHECK(iocContainer.get<int>() == 5);
+
+    iocContainer.registerFactory<double>([](unique_ptr<int>&& value) {
+        return make_unique<double>(*value);
+    });
+
+    auto value = make_unique<int>(6);
+    CHECK(iocContainer.tryCreate<double>(value) == ErrorCode::InvalidArgument);
+    CHECK(iocContainer.tryCreateWithoutStoring<double>(std::move(value)).value() != nullptr);
+
+    CHECK(iocContainer.tryAlias<double>("ratio", "") == ErrorCode::NotFound);
+    CHECK(iocContainer.tryAlias<string>("copy", "three") == ErrorCode::None);
+    CHECK(iocContainer.tryGetSwappable<string>().error() == ErrorCode::NotFound);
+    CHECK(iocContainer.tryBorrow<string>("three").error() == ErrorCode::InvalidArgument);
+    auto lender = iocContainer.tryLend<string>("copy");
+    CHECK(lender && *(*lender)->borrow() == "xxx");
+    CHECK(iocContainer.tryGetReplicas<string>().error() == ErrorCode::NotFound);
+    CHECK(iocContainer.tryGetThreadLocal<string>().error() == ErrorCode::NotFound);
+    CHECK(iocContainer.tryForEachReplica<string>([](string&) {}) == ErrorCode::NotFound);
+    CHECK((iocContainer.tryMemoizationStats<string, int>().error() == ErrorCode::NotMemoized));
+
+    auto& child = iocContainer.getRef<IocContainer>();
+    CHECK(child.tryCreateByName<string>("four", 4) == ErrorCode::None);
+    CHECK(child.tryGetPtr<double>().error() == ErrorCode::NotFound);
+
+    return failures == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}